@@ -0,0 +1,82 @@
+// AdaptiveRadixTree against the AVL and red-black trees on 64-bit keys, dense (0..n-1) and sparse
+// (random), as n grows: insert and lookup latency and the bytes each structure holds per key
+// usage: art_lookup [max keys] [lookups]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../tree/adaptive_radix_tree.h"
+#include "../tree/avl_tree.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Function>
+double time_ns(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+void report(const std::string & structure, std::size_t n, double insert_ns, double find_ns, double bytes) {
+    std::cout << std::left << std::setw(12) << structure << std::right << std::setw(10) << n << std::setw(12) << insert_ns
+              << std::setw(12) << find_ns << std::setw(12) << bytes << std::endl;
+}
+
+// node bytes for the comparison trees: one node per key, plus its slot in the value column
+template <typename Tree>
+double tree_bytes(const Tree & tree) {
+    return double(sizeof(*tree.root) + sizeof(Empty));
+}
+
+double art_bytes(const AdaptiveRadixTree<std::uint64_t> & tree) {
+    return double(tree.memory()) / double(tree.size() ? tree.size() : 1);
+}
+
+template <typename Tree, typename Bytes>
+void measure(const std::string & name, const std::vector<std::uint64_t> & keys, const std::vector<std::uint64_t> & probes, Bytes bytes) {
+    Tree tree;
+    auto insert_ns = time_ns([&] { for (auto k : keys) tree.insert(k); });
+    long long found = 0;
+    auto find_ns = time_ns([&] { for (auto k : probes) found += bool(tree.find(k)); });
+    sink = found;
+    report(name, keys.size(), insert_ns / double(keys.size()), find_ns / double(probes.size()), bytes(tree));
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t max_keys = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::size_t lookups = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::mt19937_64 gen(47);
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (auto dense : { true, false }) {
+        std::cout << (dense ? "dense keys, 0..n-1 shuffled" : "sparse keys, random 64-bit") << std::endl;
+        std::cout << std::left << std::setw(12) << "structure" << std::right << std::setw(10) << "n" << std::setw(12) << "ns/insert"
+                  << std::setw(12) << "ns/find" << std::setw(12) << "bytes/key" << std::endl;
+        for (std::size_t n = 10000; n <= max_keys; n *= 10) {
+            std::vector<std::uint64_t> keys(n), probes(lookups);
+            if (dense) {
+                std::iota(keys.begin(), keys.end(), 0);
+                std::shuffle(keys.begin(), keys.end(), gen);
+            }
+            else {
+                for (auto && k : keys) k = gen();
+            }
+            // all hits, in random order
+            for (auto && p : probes) p = keys[gen() % n];
+
+            measure<AdaptiveRadixTree<std::uint64_t>>("art", keys, probes, art_bytes);
+            measure<AVLTree<std::uint64_t>>("avl", keys, probes, tree_bytes<AVLTree<std::uint64_t>>);
+            measure<RedBlackTree<std::uint64_t>>("red-black", keys, probes, tree_bytes<RedBlackTree<std::uint64_t>>);
+        }
+    }
+}
@@ -0,0 +1,300 @@
+// every sort kernel and tree over the standard input shapes, reported as JSON
+//
+// usage: benchmark [--min-size N] [--max-size N] [--quadratic-limit N] [--tree-limit N]
+//                  [--timeout SECONDS] [--perturb PERCENT] [--only NAME] [--label TEXT]
+//                  [--output FILE]
+//
+// sizes run in powers of ten from --min-size (default 10^3) to --max-size
+// (default 10^6, up to 10^9). every case runs in its own child process, so
+// peak RSS is per case, and a kernel that overflows its stack or runs past
+// --timeout is recorded instead of ending the run. --label tags the report,
+// e.g. with `git describe`, so reports from different versions can be diffed.
+// built with -DTREE_STATS, tree cases also report rotations, recolorings and
+// the other tree counters of their counted run.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "distributions.h"
+#include "../sort/bubblesort.h"
+#include "../sort/heapsort.h"
+#include "../sort/insertionsort.h"
+#include "../sort/mergesort.h"
+#include "../sort/quicksort.h"
+#include "../sort/sort.h"
+#include "../tree/binary_search_tree.h"
+#include "../tree/avl_tree.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+#include "../tree/splay_tree.h"
+
+// an int that counts every comparison and every copy made of it
+struct Counted {
+    int value;
+    static std::uint64_t comparisons;
+    static std::uint64_t moves;
+
+    Counted(): value(0) {}
+    Counted(int v): value(v) {}
+    Counted(const Counted & other): value(other.value) { ++moves; }
+    Counted & operator=(const Counted & other) { value = other.value; ++moves; return *this; }
+
+    static void reset() { comparisons = 0; moves = 0; }
+
+    friend bool operator<(const Counted & lhs, const Counted & rhs) { ++comparisons; return lhs.value < rhs.value; }
+    friend bool operator>(const Counted & lhs, const Counted & rhs) { ++comparisons; return lhs.value > rhs.value; }
+    friend bool operator<=(const Counted & lhs, const Counted & rhs) { ++comparisons; return lhs.value <= rhs.value; }
+    friend bool operator>=(const Counted & lhs, const Counted & rhs) { ++comparisons; return lhs.value >= rhs.value; }
+    friend bool operator==(const Counted & lhs, const Counted & rhs) { ++comparisons; return lhs.value == rhs.value; }
+    friend bool operator!=(const Counted & lhs, const Counted & rhs) { ++comparisons; return lhs.value != rhs.value; }
+};
+std::uint64_t Counted::comparisons = 0;
+std::uint64_t Counted::moves = 0;
+
+struct Case {
+    Distributions distribution;
+    std::size_t n;
+    double perturb;
+    std::uint64_t seed;
+};
+
+// what a child process sends back
+struct Measurement {
+    double ns_per_element;
+    std::uint64_t comparisons;
+    std::uint64_t moves;
+    StatsSnapshot tree_stats;
+    long peak_rss_kb;
+    bool correct;
+};
+
+template <typename Function>
+double elapsed_ns(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+// sort kernels, adapted to a whole vector
+struct Bubblesort { template <typename T> void operator()(std::vector<T> & vec) const { bubblesort(vec); } };
+struct Insertionsort { template <typename T> void operator()(std::vector<T> & vec) const { insertionsort(vec); } };
+struct Quicksort { template <typename T> void operator()(std::vector<T> & vec) const { quicksort(vec, 0, int(vec.size()) - 1); } };
+struct Mergesort {
+    template <typename T> void operator()(std::vector<T> & vec) const {
+        std::vector<T> temp(vec.size());
+        mergesort(vec, 0, int(vec.size()) - 1, temp);
+    }
+};
+// the dispatcher; the timed int run may pick counting or radix sort, while the
+// counted run only sees comparison kernels, as Counted is not an integer
+struct Adaptive { template <typename T> void operator()(std::vector<T> & vec) const { sort(vec); } };
+// heapSort works on vec[1..last]; the input gets its unused slot 0 before timing starts
+struct Heapsort { template <typename T> void operator()(std::vector<T> & vec) const { heapSort(vec, int(vec.size()) - 1); } };
+
+template <typename Kernel, bool OneBased = false>
+Measurement measure_sort(const Case & c) {
+    Measurement m = {};
+    {
+        auto vec = generate<int>(c.distribution, c.n, c.perturb, c.seed);
+        if (OneBased) vec.insert(vec.begin(), 0);
+        m.ns_per_element = elapsed_ns([&] { Kernel()(vec); }) / c.n;
+        m.correct = std::is_sorted(vec.begin() + OneBased, vec.end());
+    }
+    auto vec = generate<Counted>(c.distribution, c.n, c.perturb, c.seed);
+    if (OneBased) vec.insert(vec.begin(), Counted());
+    Counted::reset();
+    Kernel()(vec);
+    m.comparisons = Counted::comparisons;
+    m.moves = Counted::moves;
+    return m;
+}
+
+// trees, each timed per operation over the keys of the input in input order
+struct BST { template <typename K> using tree = BinarySearchTree<K>; };
+struct AVL { template <typename K> using tree = AVLTree<K>; };
+struct RB { template <typename K> using tree = RedBlackTree<K>; };
+struct Splay { template <typename K> using tree = SplayTree<K>; };
+
+enum class Phases { insert, find, remove };
+
+template <typename Family, Phases Phase, typename K>
+double run_phase(const Case & c, bool & correct) {
+    auto keys = generate<K>(c.distribution, c.n, c.perturb, c.seed);
+    typename Family::template tree<K> tree;
+    if (Phase != Phases::insert) {
+        for (auto && k : keys) tree.insert(k);
+    }
+    Counted::reset();
+    TreeStats::reset();
+    return elapsed_ns([&] {
+        switch (Phase) {
+            case Phases::insert: for (auto && k : keys) tree.insert(k); break;
+            case Phases::find: for (auto && k : keys) correct = tree.find(k) && correct; break;
+            case Phases::remove: for (auto && k : keys) tree.remove(k); break;
+        }
+    });
+}
+
+template <typename Family, Phases Phase>
+Measurement measure_tree(const Case & c) {
+    Measurement m = {};
+    m.correct = true;
+    m.ns_per_element = run_phase<Family, Phase, int>(c, m.correct) / c.n;
+    run_phase<Family, Phase, Counted>(c, m.correct);
+    m.comparisons = Counted::comparisons;
+    m.moves = Counted::moves;
+    m.tree_stats = TreeStats::snapshot();
+    return m;
+}
+
+enum class Families { sort, tree };
+
+struct Entry {
+    std::string name;
+    Families family;
+    bool quadratic;  // only run up to --quadratic-limit
+    Measurement (*measure)(const Case &);
+};
+
+const std::vector<Entry> & entries() {
+    static const std::vector<Entry> all = {
+        { "bubblesort", Families::sort, true, measure_sort<Bubblesort> },
+        { "insertionsort", Families::sort, true, measure_sort<Insertionsort> },
+        { "heapsort", Families::sort, false, measure_sort<Heapsort, true> },
+        { "mergesort", Families::sort, false, measure_sort<Mergesort> },
+        { "quicksort", Families::sort, false, measure_sort<Quicksort> },
+        { "sort", Families::sort, false, measure_sort<Adaptive> },
+        // removal in BinarySearchTree cannot unlink the root or a node with two children
+        { "bst.insert", Families::tree, false, measure_tree<BST, Phases::insert> },
+        { "bst.find", Families::tree, false, measure_tree<BST, Phases::find> },
+        { "avl.insert", Families::tree, false, measure_tree<AVL, Phases::insert> },
+        { "avl.find", Families::tree, false, measure_tree<AVL, Phases::find> },
+        { "avl.remove", Families::tree, false, measure_tree<AVL, Phases::remove> },
+        { "red-black.insert", Families::tree, false, measure_tree<RB, Phases::insert> },
+        { "red-black.find", Families::tree, false, measure_tree<RB, Phases::find> },
+        { "red-black.remove", Families::tree, false, measure_tree<RB, Phases::remove> },
+        { "splay.insert", Families::tree, false, measure_tree<Splay, Phases::insert> },
+        { "splay.find", Families::tree, false, measure_tree<Splay, Phases::find> },
+        { "splay.remove", Families::tree, false, measure_tree<Splay, Phases::remove> },
+    };
+    return all;
+}
+
+// runs one case in a child process and describes how it ended
+std::string run_isolated(const Entry & entry, const Case & c, unsigned timeout, Measurement & m) {
+    int fds[2];
+    if (::pipe(fds) != 0) return "failed";
+    auto pid = ::fork();
+    if (pid < 0) return "failed";
+    if (pid == 0) {
+        ::close(fds[0]);
+        // kernels that print diagnostics must not interleave with the report
+        int null = ::open("/dev/null", O_WRONLY);
+        if (null >= 0) ::dup2(null, STDOUT_FILENO);
+        ::alarm(timeout);
+        auto result = entry.measure(c);
+        struct rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+        result.peak_rss_kb = usage.ru_maxrss;
+        auto written = ::write(fds[1], &result, sizeof(result));
+        ::_exit(written == sizeof(result) ? 0 : 1);
+    }
+    ::close(fds[1]);
+    auto got = ::read(fds[0], &m, sizeof(m));
+    ::close(fds[0]);
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status)) {
+        if (WTERMSIG(status) == SIGALRM) return "timeout";
+        return "crashed (signal " + std::to_string(WTERMSIG(status)) + ")";
+    }
+    if (got != sizeof(m)) return "failed";
+    return m.correct ? "ok" : "wrong result";
+}
+
+std::string escape(const std::string & text) {
+    std::string out;
+    for (auto ch : text) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        if (static_cast<unsigned char>(ch) >= 0x20) out += ch;
+    }
+    return out;
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t min_size = 1000, max_size = 1000000, quadratic_limit = 100000, tree_limit = 10000000;
+    unsigned timeout = 60;
+    double perturb = 1;
+    std::string only, label, output;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i], value = argv[i + 1];
+        if (flag == "--min-size") min_size = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--max-size") max_size = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--quadratic-limit") quadratic_limit = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--tree-limit") tree_limit = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--timeout") timeout = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--perturb") perturb = std::strtod(value.c_str(), nullptr);
+        else if (flag == "--only") only = value;
+        else if (flag == "--label") label = value;
+        else if (flag == "--output") output = value;
+        else { std::cerr << "unknown option " << flag << std::endl; return 1; }
+    }
+
+    std::ostringstream json;
+    json << std::setprecision(6);
+    json << "{\n  \"label\": \"" << escape(label) << "\",\n"
+         << "  \"compiler\": \"" << escape(__VERSION__) << "\",\n"
+         << "  \"timestamp\": " << std::time(nullptr) << ",\n"
+         << "  \"results\": [";
+    bool first = true;
+
+    for (std::size_t n = min_size; n <= max_size; n *= 10) {
+        for (auto && entry : entries()) {
+            if (!only.empty() && entry.name.compare(0, only.size(), only) != 0) continue;
+            if (entry.quadratic && n > quadratic_limit) continue;
+            if (entry.family == Families::tree && n > tree_limit) continue;
+            for (auto distribution : all_distributions()) {
+                Case c = { distribution, n, perturb, 0x5eed + n };
+                auto name = distribution_name(distribution, perturb);
+                std::cerr << entry.name << " " << name << " " << n << ": " << std::flush;
+                Measurement m = {};
+                auto status = run_isolated(entry, c, timeout, m);
+                std::cerr << status << std::endl;
+
+                json << (first ? "\n" : ",\n") << "    {\"kernel\": \"" << entry.name << "\", \"distribution\": \"" << name
+                     << "\", \"n\": " << n << ", \"status\": \"" << status << "\"";
+                if (status == "ok" || status == "wrong result") {
+                    json << ", \"ns_per_element\": " << m.ns_per_element << ", \"comparisons\": " << m.comparisons
+                         << ", \"moves\": " << m.moves << ", \"peak_rss_kb\": " << m.peak_rss_kb;
+                    if (TreeStats::enabled && entry.family == Families::tree) {
+                        // comparisons are already counted through the keys
+                        for (int i = 1; i < static_cast<int>(Counters::count); ++i) {
+                            auto counter = static_cast<Counters>(i);
+                            json << ", \"" << counter_name(counter) << "\": " << m.tree_stats[counter];
+                        }
+                    }
+                }
+                json << "}";
+                first = false;
+            }
+        }
+        if (n > max_size / 10) break;  // the next step would overflow or pass max_size
+    }
+    json << "\n  ]\n}\n";
+
+    if (output.empty()) std::cout << json.str();
+    else std::ofstream(output) << json.str();
+}
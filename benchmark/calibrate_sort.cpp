@@ -0,0 +1,126 @@
+// measures where the sort kernels cross over on this host and writes thresholds for sort()
+// usage: calibrate_sort [output file]; then run with SORT_THRESHOLDS=<file>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "../sort/sort.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+// best of a few runs over a fresh copy of input each time
+template <typename T, typename Kernel>
+double time_ns(const std::vector<T> & input, Kernel kernel, int repeats = 5) {
+    double best = 0;
+    for (int r = 0; r < repeats; ++r) {
+        auto vec = input;
+        auto start = std::chrono::steady_clock::now();
+        kernel(vec);
+        auto stop = std::chrono::steady_clock::now();
+        sink = sink + (long long)(vec.size());
+        auto ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        if (r == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+std::vector<int> random_ints(std::size_t n, int low, int high, std::mt19937_64 & gen) {
+    std::uniform_int_distribution<int> value(low, high);
+    std::vector<int> vec(n);
+    for (auto && i : vec) i = value(gen);
+    return vec;
+}
+
+int main(int argc, char * argv[]) {
+    std::mt19937_64 gen(7);
+    SortThresholds t;
+
+    // insertion sort against the quicksort sort() runs, bounded_quicksort, on
+    // many small arrays at once so the clock resolution does not matter;
+    // stop at the first size it loses
+    for (std::size_t n : { 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256 }) {
+        std::vector<std::vector<int>> arrays(std::max<std::size_t>(1, 65536 / n));
+        for (auto && a : arrays) a = random_ints(n, 0, 1 << 30, gen);
+        auto insertion = time_ns(arrays, [](std::vector<std::vector<int>> & all) { for (auto && a : all) insertionsort(a); });
+        auto quick = time_ns(arrays, [](std::vector<std::vector<int>> & all) { for (auto && a : all) bounded_quicksort(a, 0, int(a.size()) - 1); });
+        std::cerr << "n " << n << ": insertionsort " << insertion / arrays.size() << " ns, quicksort " << quick / arrays.size() << " ns" << std::endl;
+        if (insertion > quick) break;
+        t.insertion_limit = n;
+    }
+
+    // natural merge against the top-down mergesort that otherwise takes
+    // ordered input, on sorted doubles disturbed by more and more swaps
+    {
+        std::size_t n = 1 << 20;
+        std::vector<double> sorted(n);
+        for (std::size_t i = 0; i < n; ++i) sorted[i] = double(i);
+        std::uniform_int_distribution<std::size_t> position(0, n - 1);
+        for (double share : { 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2 }) {
+            auto vec = sorted;
+            for (std::size_t i = 0; i < std::size_t(n * share / 2); ++i) std::swap(vec[position(gen)], vec[position(gen)]);
+            auto descents = sample_input(vec, 4096).descents;
+            auto natural = time_ns(vec, [](std::vector<double> & v) { std::vector<double> temp(v.size()); naturalmergesort(v, temp); });
+            auto merge = time_ns(vec, [](std::vector<double> & v) { std::vector<double> temp(v.size()); mergesort(v, 0, int(v.size()) - 1, temp); });
+            std::cerr << "descents " << descents << ": naturalmergesort " << natural / 1e6 << " ms, mergesort " << merge / 1e6 << " ms" << std::endl;
+            if (natural > merge) break;
+            t.presorted = descents;
+        }
+    }
+
+    // counting sort against radix sort as the range of the keys widens
+    {
+        std::size_t n = 1 << 20;
+        for (double factor : { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0 }) {
+            auto vec = random_ints(n, 0, int(factor * n) - 1, gen);
+            auto counting = time_ns(vec, [](std::vector<int> & v) { countingsort(v, std::size_t(-1)); });
+            auto radix = time_ns(vec, [](std::vector<int> & v) { std::vector<int> temp; radixsort(v, temp); });
+            std::cerr << "range " << factor << "n: countingsort " << counting / 1e6 << " ms, radixsort " << radix / 1e6 << " ms" << std::endl;
+            if (counting > radix) break;
+            t.counting_range = factor;
+        }
+    }
+
+    // radix sort against quicksort on full-range keys; the first size it wins at
+    for (std::size_t n = 256; n <= (1 << 20); n *= 2) {
+        auto vec = random_ints(n, -(1 << 30), 1 << 30, gen);
+        auto radix = time_ns(vec, [](std::vector<int> & v) { std::vector<int> temp; radixsort(v, temp); });
+        auto quick = time_ns(vec, [](std::vector<int> & v) { bounded_quicksort(v, 0, int(v.size()) - 1); });
+        std::cerr << "n " << n << ": radixsort " << radix / 1e3 << " us, quicksort " << quick / 1e3 << " us" << std::endl;
+        t.radix_min = n;
+        if (radix < quick) break;
+    }
+
+    // quicksort against mergesort on doubles drawn from fewer and fewer
+    // distinct values; the cost of equal keys grows with n, so this errs low
+    // for larger inputs and skewed ones, and stops as soon as quicksort loses.
+    // bounded_quicksort gathers runs of equal pivots, so it may never lose,
+    // and then no share of duplicates sends sort() to mergesort
+    {
+        std::size_t n = 1 << 16;
+        t.duplicates = 1;
+        for (std::size_t distinct = n; distinct >= 2; distinct /= 2) {
+            std::uniform_int_distribution<std::size_t> value(0, distinct - 1);
+            std::vector<double> vec(n);
+            for (auto && i : vec) i = double(value(gen));
+            auto duplicates = sample_input(vec, t.sample).duplicates;
+            auto quick = time_ns(vec, [](std::vector<double> & v) { bounded_quicksort(v, 0, int(v.size()) - 1); });
+            auto merge = time_ns(vec, [](std::vector<double> & v) { std::vector<double> temp(v.size()); mergesort(v, 0, int(v.size()) - 1, temp); });
+            std::cerr << "duplicates " << duplicates << ": quicksort " << quick / 1e3 << " us, mergesort " << merge / 1e3 << " us" << std::endl;
+            if (quick > merge) {
+                t.duplicates = std::max(duplicates, 1.0 / t.sample);
+                break;
+            }
+        }
+    }
+
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        t.save(out);
+    }
+    else t.save(std::cout);
+}
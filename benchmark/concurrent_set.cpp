@@ -0,0 +1,105 @@
+// SkipList against a RedBlackTree behind one mutex, on 1, 2, 4 ... 64 threads sharing a set.
+// each thread runs a mix of finds, inserts, removes and short range scans over a fixed key space
+// usage: concurrent_set [keys] [operations per thread] [percent updates]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../tree/skip_list.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+// the red-black tree shared the only way it can be
+class LockedTree {
+    RedBlackTree<std::uint64_t> tree;
+    std::mutex mutex;
+
+    public:
+    bool insert(std::uint64_t key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.insert(key);
+    }
+    bool remove(std::uint64_t key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.remove(key);
+        return true;
+    }
+    bool find(std::uint64_t key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.find(key) != nullptr;
+    }
+    template <typename Function> void scan(std::uint64_t low, std::uint64_t high, Function function) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.scan(low, high, [&](std::uint64_t key, const Empty &) { function(key); });
+    }
+};
+
+// every thread gets its own seed, and the same one for both sets
+template <typename Set>
+double run_ms(Set & set, unsigned threads, std::uint64_t keys, std::size_t operations, unsigned updates) {
+    std::vector<std::thread> workers;
+    std::vector<long long> found(threads, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 gen(42 + t);
+            long long local = 0;
+            for (std::size_t i = 0; i < operations; ++i) {
+                auto key = gen() % keys;
+                auto roll = unsigned(gen() % 100);
+                if (roll < updates / 2) local += set.insert(key);
+                else if (roll < updates) local += set.remove(key);
+                else if (roll < updates + 5) set.scan(key, key + 64, [&](std::uint64_t) { ++local; });
+                else local += set.find(key);
+            }
+            found[t] = local;
+        });
+    }
+    for (auto && worker : workers) worker.join();
+    auto stop = std::chrono::steady_clock::now();
+    for (auto count : found) sink = sink + count;
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+template <typename Set>
+void prefill(Set & set, std::uint64_t keys) {
+    // half the key space, so inserts and removes succeed about as often
+    std::mt19937_64 gen(7);
+    for (std::uint64_t i = 0; i < keys / 2; ++i) set.insert(gen() % keys);
+}
+
+void report(unsigned threads, std::size_t total, double skip_ms, double locked_ms) {
+    std::cout << std::setw(8) << threads << std::setw(16) << double(total) / skip_ms / 1000
+              << std::setw(16) << double(total) / locked_ms / 1000 << std::setw(10) << locked_ms / skip_ms << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+    std::uint64_t keys = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t operations = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    unsigned updates = (argc > 3) ? unsigned(std::atoi(argv[3])) : 20;
+    if (updates > 95) updates = 95;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << keys << " keys, " << operations << " operations per thread, " << updates
+              << "% updates, 5% scans of 64 keys" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "skip list Mops" << std::setw(16) << "locked rb Mops"
+              << std::setw(10) << "ratio" << std::endl;
+    for (unsigned threads = 1; threads <= 64; threads *= 2) {
+        SkipList<std::uint64_t> list;
+        LockedTree tree;
+        prefill(list, keys);
+        prefill(tree, keys);
+        auto skip_ms = run_ms(list, threads, keys, operations, updates);
+        auto locked_ms = run_ms(tree, threads, keys, operations, updates);
+        report(threads, std::size_t(threads) * operations, skip_ms, locked_ms);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef DISTRIBUTIONS_H
+#define DISTRIBUTIONS_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+
+// Zipf ranks 1..n by rejection-inversion (Hörmann and Derflinger), constant
+// memory, so it also works at sizes where a cumulative table would not fit
+class ZipfSampler {
+    double skew;
+    double n;
+    double h_integral_x1;
+    double h_integral_n;
+    double s;
+    std::uniform_real_distribution<double> uniform;
+
+    static double helper1(double x) { return (std::abs(x) > 1e-8) ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x)); }
+    static double helper2(double x) { return (std::abs(x) > 1e-8) ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x)); }
+    double h(double x) const { return std::exp(-skew * std::log(x)); }
+    double h_integral(double x) const { auto log_x = std::log(x); return helper2((1 - skew) * log_x) * log_x; }
+    double h_integral_inverse(double x) const {
+        auto t = x * (1 - skew);
+        if (t < -1) t = -1;
+        return std::exp(helper1(t) * x);
+    }
+
+    public:
+    ZipfSampler(std::uint64_t count, double exponent)
+        : skew(exponent), n(double(count)), uniform(0.0, 1.0) {
+        h_integral_x1 = h_integral(1.5) - 1;
+        h_integral_n = h_integral(n + 0.5);
+        s = 2 - h_integral_inverse(h_integral(2.5) - h(2));
+    }
+
+    template <typename Generator>
+    std::uint64_t operator()(Generator & gen) {
+        while (true) {
+            auto u = h_integral_n + uniform(gen) * (h_integral_x1 - h_integral_n);
+            auto x = h_integral_inverse(u);
+            auto k = std::floor(x + 0.5);
+            if (k < 1) k = 1;
+            else if (k > n) k = n;
+            if (k - x <= s || u >= h_integral(k + 0.5) - h(k)) return std::uint64_t(k);
+        }
+    }
+};
+
+// input shapes every kernel is run against; `perturb` is the percentage of
+// positions disturbed by random swaps in the nearly-sorted shape
+enum class Distributions { random, sorted, reverse, organ_pipe, few_unique, zipf, nearly_sorted };
+
+inline const std::vector<Distributions> & all_distributions() {
+    static const std::vector<Distributions> all = {
+        Distributions::random, Distributions::sorted, Distributions::reverse, Distributions::organ_pipe,
+        Distributions::few_unique, Distributions::zipf, Distributions::nearly_sorted,
+    };
+    return all;
+}
+
+inline std::string distribution_name(Distributions distribution, double perturb) {
+    switch (distribution) {
+        case Distributions::random: return "random";
+        case Distributions::sorted: return "sorted";
+        case Distributions::reverse: return "reverse";
+        case Distributions::organ_pipe: return "organ-pipe";
+        case Distributions::few_unique: return "few-unique";
+        case Distributions::zipf: return "zipf";
+        case Distributions::nearly_sorted: {
+            auto text = std::to_string(perturb);
+            text.erase(text.find_last_not_of('0') + 1);
+            if (text.back() == '.') text.pop_back();
+            return "nearly-sorted-" + text + "%";
+        }
+    }
+    return "unknown";
+}
+
+// fills n int keys; T only has to be constructible from int
+template <typename T>
+std::vector<T> generate(Distributions distribution, std::size_t n, double perturb, std::uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> vec;
+    vec.reserve(n);
+    switch (distribution) {
+        case Distributions::random: {
+            std::uniform_int_distribution<int> value(0, 2147483647);
+            for (std::size_t i = 0; i < n; ++i) vec.emplace_back(value(gen));
+            break;
+        }
+        case Distributions::sorted: {
+            for (std::size_t i = 0; i < n; ++i) vec.emplace_back(int(i));
+            break;
+        }
+        case Distributions::reverse: {
+            for (std::size_t i = n; i > 0; --i) vec.emplace_back(int(i - 1));
+            break;
+        }
+        case Distributions::organ_pipe: {
+            for (std::size_t i = 0; i < n; ++i) vec.emplace_back(int((i < n / 2) ? i : n - 1 - i));
+            break;
+        }
+        case Distributions::few_unique: {
+            std::uniform_int_distribution<int> value(0, 15);
+            for (std::size_t i = 0; i < n; ++i) vec.emplace_back(value(gen));
+            break;
+        }
+        case Distributions::zipf: {
+            ZipfSampler zipf(n, 1.0);
+            for (std::size_t i = 0; i < n; ++i) vec.emplace_back(int(zipf(gen)));
+            break;
+        }
+        case Distributions::nearly_sorted: {
+            for (std::size_t i = 0; i < n; ++i) vec.emplace_back(int(i));
+            if (n < 2) break;
+            std::uniform_int_distribution<std::size_t> position(0, n - 1);
+            auto swaps = std::size_t(n * perturb / 200);  // each swap disturbs two positions
+            for (std::size_t i = 0; i < swaps; ++i) std::swap(vec[position(gen)], vec[position(gen)]);
+            break;
+        }
+    }
+    return vec;
+}
+
+#endif
@@ -0,0 +1,93 @@
+// point lookups on the AVL and red-black trees alone, with a hash index of every key beside them,
+// and with a CLOCK cache of the hottest keys, on uniform and Zipf-distributed keys
+// usage: indexed_lookup [keys] [lookups] [cache keys]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../tree/indexed_tree.h"
+#include "../tree/avl_tree.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+#include "distributions.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Function>
+double time_ns(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+void report(const std::string & structure, double find_ns, double indexed) {
+    std::cout << std::left << std::setw(22) << structure << std::right << std::setw(12) << find_ns << std::setw(12) << std::setprecision(0) << indexed << std::setprecision(1) << std::endl;
+}
+
+template <typename Tree>
+void measure(const std::string & name, Tree & tree, const std::vector<std::int64_t> & probes) {
+    long long found = 0;
+    auto ns = time_ns([&] { for (auto k : probes) found += bool(tree.find(k)); });
+    sink = found;
+    report(name, ns / double(probes.size()), 0);
+}
+
+// the same for the indexed trees, with how many keys the index held after
+template <typename Tree>
+void measure_indexed(const std::string & name, Tree & tree, const std::vector<std::int64_t> & probes) {
+    long long found = 0;
+    auto ns = time_ns([&] { for (auto k : probes) found += bool(tree.find(k)); });
+    sink = found;
+    report(name, ns / double(probes.size()), double(tree.indexed()));
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t lookups = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 4000000;
+    std::size_t cache_keys = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : n / 100;
+    std::mt19937_64 gen(50);
+
+    // sparse keys, inserted in random order
+    std::vector<std::int64_t> keys(n);
+    for (auto && k : keys) k = std::int64_t(gen() >> 1);
+    AVLTree<std::int64_t> avl;
+    RedBlackTree<std::int64_t> rbt;
+    IndexedTree<std::int64_t> avl_indexed;
+    IndexedTree<std::int64_t, RedBlackTree<std::int64_t>> rbt_indexed;
+    IndexedTree<std::int64_t> avl_cached(cache_keys);
+    IndexedTree<std::int64_t, RedBlackTree<std::int64_t>> rbt_cached(cache_keys);
+    for (auto k : keys) {
+        avl.insert(k);
+        rbt.insert(k);
+        avl_indexed.insert(k);
+        rbt_indexed.insert(k);
+        avl_cached.insert(k);
+        rbt_cached.insert(k);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " keys, cache of " << cache_keys << std::endl;
+    for (auto zipf : { false, true }) {
+        std::vector<std::int64_t> probes(lookups);
+        ZipfSampler sampler(n, 0.99);
+        // the hot ranks land on random keys, not on the smallest ones
+        for (auto && p : probes) p = keys[zipf ? sampler(gen) - 1 : gen() % n];
+
+        std::cout << (zipf ? "zipf 0.99 lookups, all hits" : "uniform lookups, all hits") << std::endl;
+        std::cout << std::left << std::setw(22) << "structure" << std::right << std::setw(12) << "ns/find" << std::setw(12) << "indexed" << std::endl;
+        measure("avl", avl, probes);
+        measure("red-black", rbt, probes);
+        measure_indexed("avl, full index", avl_indexed, probes);
+        measure_indexed("red-black, full index", rbt_indexed, probes);
+        measure_indexed("avl, cache", avl_cached, probes);
+        measure_indexed("red-black, cache", rbt_cached, probes);
+    }
+}
@@ -0,0 +1,86 @@
+// overlap queries on IntervalTree, one at a time and batched, against a sweep over a sorted array
+// usage: interval_overlap [intervals] [queries] [max length]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "../tree/interval_tree.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+// the baseline: intervals sorted by low endpoint, every one starting at or
+// before b is checked, because any of them may still reach a
+long long sweep(const std::vector<Interval<long>> & sorted, long a, long b) {
+    long long hits = 0;
+    auto end = std::upper_bound(sorted.begin(), sorted.end(), b,
+                                [](long value, const Interval<long> & interval) { return value < interval.low; });
+    for (auto it = sorted.begin(); it != end; ++it) {
+        if (!(it->high < a)) hits += it->low;
+    }
+    return hits;
+}
+
+template <typename Function>
+double time_ns(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t m = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 10000;
+    long length = (argc > 3) ? std::strtol(argv[3], nullptr, 10) : 1000;
+    long span = 1000000000;
+    std::mt19937_64 gen(2024);
+    std::uniform_int_distribution<long> start(0, span), size(0, length);
+
+    std::vector<Interval<long>> intervals(n);
+    for (auto && interval : intervals) {
+        interval.low = start(gen);
+        interval.high = interval.low + size(gen);
+    }
+    std::vector<Interval<long>> queries(m);
+    for (auto && query : queries) {
+        query.low = start(gen);
+        query.high = query.low + size(gen);
+    }
+
+    IntervalTree<long> tree;
+    auto build_tree = time_ns([&] { for (auto && interval : intervals) tree.insert(interval); });
+    std::vector<Interval<long>> sorted = intervals;
+    auto build_sorted = time_ns([&] { std::sort(sorted.begin(), sorted.end(), IntervalLess<long>()); });
+
+    long long expected = 0, single = 0, batched = 0;
+    auto sweep_ns = time_ns([&] { for (auto && q : queries) expected += sweep(sorted, q.low, q.high); });
+    auto single_ns = time_ns([&] {
+        for (auto && q : queries) {
+            tree.overlap(q.low, q.high, [&](const Interval<long> & interval, const Empty &) { single += interval.low; });
+        }
+    });
+    auto batch_ns = time_ns([&] {
+        tree.overlap(queries, [&](std::size_t, const Interval<long> & interval, const Empty &) { batched += interval.low; });
+    });
+    sink = expected + single + batched;
+    if (single != expected || batched != expected) {
+        std::cerr << "result mismatch" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "intervals " << n << ", queries " << m << ", max length " << length << std::endl;
+    std::cout << std::left << std::setw(16) << "method" << std::right << std::setw(14) << "build ms"
+              << std::setw(14) << "ns/query" << std::endl;
+    std::cout << std::left << std::setw(16) << "sorted sweep" << std::right << std::setw(14) << build_sorted / 1e6
+              << std::setw(14) << sweep_ns / m << std::endl;
+    std::cout << std::left << std::setw(16) << "tree" << std::right << std::setw(14) << build_tree / 1e6
+              << std::setw(14) << single_ns / m << std::endl;
+    std::cout << std::left << std::setw(16) << "tree, batched" << std::right << std::setw(14) << build_tree / 1e6
+              << std::setw(14) << batch_ns / m << std::endl;
+}
@@ -0,0 +1,70 @@
+// ingest throughput of LSMSet against the AVL and red-black trees, then lookups and a range scan
+// usage: lsm_ingest [keys] [lookups]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../tree/lsm_set.h"
+#include "../tree/avl_tree.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Function>
+double time_ns(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+void report(const std::string & method, double insert_ns, double find_ns, std::size_t found) {
+    std::cout << std::left << std::setw(16) << method << std::right << std::setw(14) << insert_ns
+              << std::setw(14) << find_ns << std::setw(12) << found << std::endl;
+}
+
+template <typename Set>
+void measure(const std::string & name, Set & set, const std::vector<std::uint64_t> & keys, const std::vector<std::uint64_t> & probes) {
+    auto insert_ns = time_ns([&] { for (auto k : keys) set.insert(k); });
+    std::size_t found = 0;
+    auto find_ns = time_ns([&] { for (auto k : probes) found += bool(set.find(k)); });
+    report(name, insert_ns / double(keys.size()), find_ns / double(probes.size()), found);
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::size_t lookups = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::mt19937_64 gen(41);
+    std::vector<std::uint64_t> keys(n), probes(lookups);
+    for (auto && k : keys) k = gen() % (4 * n);
+    // half of the probes were inserted, half most likely were not
+    for (std::size_t i = 0; i < lookups; ++i) probes[i] = (i % 2) ? keys[gen() % n] : gen() % (4 * n);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " random keys, " << lookups << " lookups" << std::endl;
+    std::cout << std::left << std::setw(16) << "structure" << std::right << std::setw(14) << "ns/insert"
+              << std::setw(14) << "ns/find" << std::setw(12) << "found" << std::endl;
+    {
+        LSMSet<std::uint64_t> set;
+        measure("lsm", set, keys, probes);
+        std::cout << "  " << set.level_count() << " levels" << std::endl;
+        std::size_t scanned = 0;
+        auto scan_ns = time_ns([&] { set.scan(0, n, [&](std::uint64_t) { ++scanned; }); });
+        std::cout << "  scan of a quarter of the key space: " << scan_ns / double(scanned ? scanned : 1) << " ns/key" << std::endl;
+    }
+    {
+        AVLTree<std::uint64_t> tree;
+        measure("avl", tree, keys, probes);
+    }
+    {
+        RedBlackTree<std::uint64_t> tree;
+        measure("red-black", tree, keys, probes);
+    }
+    sink = (long long)n;
+}
@@ -0,0 +1,78 @@
+// sorting (tenant, timestamp desc, id) rows: a comparator that branches on each field, against
+// normalized byte keys under the radix and multikey quicksort kernels
+// usage: multicolumn_sort [rows] [tenants]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../sort/normalized_key.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+struct Event {
+    std::string tenant;
+    std::int64_t timestamp;
+    std::uint64_t id;
+};
+
+template <typename Function>
+double time_ms(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void report(const std::string & method, double ms, bool correct) {
+    std::cout << std::left << std::setw(34) << method << std::right << std::setw(12) << ms
+              << (correct ? "" : "  wrong result") << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t tenants = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    std::mt19937_64 gen(49);
+    std::vector<Event> events(n);
+    for (auto && e : events) {
+        e.tenant = "tenant-" + std::to_string(gen() % tenants);
+        // coarse timestamps, so the id often decides
+        e.timestamp = std::int64_t(1700000000 + gen() % 100000);
+        e.id = gen();
+    }
+    auto less = [](const Event & a, const Event & b) {
+        if (a.tenant != b.tenant) return a.tenant < b.tenant;
+        if (a.timestamp != b.timestamp) return a.timestamp > b.timestamp;
+        return a.id < b.id;
+    };
+    SortKey<Event> key;
+    key.column([](const Event & e) { return std::string_view(e.tenant); })
+       .column([](const Event & e) { return e.timestamp; }, Order::descending)
+       .column([](const Event & e) { return e.id; });
+
+    std::vector<std::size_t> expected(n), perm;
+    for (std::size_t i = 0; i < n; ++i) expected[i] = i;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " rows, " << tenants << " tenants" << std::endl;
+    std::cout << std::left << std::setw(34) << "method" << std::right << std::setw(12) << "ms" << std::endl;
+
+    // arguments are evaluated in no particular order, so each time is taken before its check
+    auto ms = time_ms([&] { std::stable_sort(expected.begin(), expected.end(), [&](std::size_t a, std::size_t b) { return less(events[a], events[b]); }); });
+    report("std::stable_sort, comparator", ms, true);
+    ms = time_ms([&] { perm = argsort_normalized(events, key, NormalizedKernels::radix); });
+    report("normalized keys, msd radix", ms, perm == expected);
+    ms = time_ms([&] { perm = argsort_normalized(events, key, NormalizedKernels::quick); });
+    report("normalized keys, multikey quick", ms, perm == expected);
+
+    std::string encoded;
+    ms = time_ms([&] { for (auto && e : events) key.encode(e, encoded); });
+    report("  of which encoding", ms, true);
+    sink = (long long)(encoded.size() + perm.size());
+}
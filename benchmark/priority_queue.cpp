@@ -0,0 +1,202 @@
+// PriorityQueue at arities 2, 4 and 8 and RadixHeap against std::priority_queue: push/pop,
+// bulk build, and Dijkstra on a random graph, where only PriorityQueue can decrease a key
+// in place and the others push duplicates and skip the stale ones
+// usage: priority_queue [elements] [vertices]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../sort/priority_queue.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Function>
+double time_ms(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void report(const std::string & method, double ms) {
+    std::cout << std::left << std::setw(34) << method << std::right << std::setw(12) << ms << std::endl;
+}
+
+template <unsigned Arity>
+void push_pop(const std::vector<std::uint32_t> & input) {
+    report("PriorityQueue<" + std::to_string(Arity) + ">", time_ms([&] {
+        PriorityQueue<std::uint32_t, std::greater<std::uint32_t>, Arity> queue;
+        for (auto i : input) queue.push(i);
+        long long sum = 0;
+        while (!queue.empty()) {
+            sum += queue.top();
+            queue.pop();
+        }
+        sink = sum;
+    }));
+}
+
+template <unsigned Arity>
+void build(const std::vector<std::uint32_t> & input) {
+    report("PriorityQueue<" + std::to_string(Arity) + ">::heapify", time_ms([&] {
+        PriorityQueue<std::uint32_t, std::greater<std::uint32_t>, Arity> queue;
+        queue.heapify(input.begin(), input.end());
+        sink = queue.top();
+    }));
+}
+
+struct Edge {
+    std::uint32_t to;
+    std::uint32_t weight;
+};
+using Graph = std::vector<std::vector<Edge>>;
+
+constexpr std::uint64_t unreached = std::uint64_t(-1);
+
+// a queued vertex ordered by its tentative distance
+struct Tentative {
+    std::uint64_t distance;
+    std::uint32_t vertex;
+
+    bool operator>(const Tentative & rhs) const { return distance > rhs.distance; }
+};
+
+std::uint64_t dijkstra_std(const Graph & graph) {
+    std::vector<std::uint64_t> distance(graph.size(), unreached);
+    std::priority_queue<Tentative, std::vector<Tentative>, std::greater<Tentative>> queue;
+    distance[0] = 0;
+    queue.push({ 0, 0 });
+    while (!queue.empty()) {
+        auto current = queue.top();
+        queue.pop();
+        if (current.distance != distance[current.vertex]) continue;
+        for (auto && edge : graph[current.vertex]) {
+            auto d = current.distance + edge.weight;
+            if (d < distance[edge.to]) {
+                distance[edge.to] = d;
+                queue.push({ d, edge.to });
+            }
+        }
+    }
+    std::uint64_t sum = 0;
+    for (auto d : distance) sum += (d == unreached) ? 0 : d;
+    return sum;
+}
+
+template <unsigned Arity>
+std::uint64_t dijkstra_addressable(const Graph & graph) {
+    using Queue = PriorityQueue<Tentative, std::greater<Tentative>, Arity>;
+    std::vector<std::uint64_t> distance(graph.size(), unreached);
+    std::vector<typename Queue::Handle> handle(graph.size());
+    std::vector<char> queued(graph.size(), 0);
+    Queue queue;
+    distance[0] = 0;
+    handle[0] = queue.push({ 0, 0 });
+    queued[0] = 1;
+    while (!queue.empty()) {
+        auto current = queue.top();
+        queue.pop();
+        queued[current.vertex] = 0;
+        for (auto && edge : graph[current.vertex]) {
+            auto d = current.distance + edge.weight;
+            if (d < distance[edge.to]) {
+                distance[edge.to] = d;
+                if (queued[edge.to]) queue.decrease_key(handle[edge.to], { d, edge.to });
+                else {
+                    handle[edge.to] = queue.push({ d, edge.to });
+                    queued[edge.to] = 1;
+                }
+            }
+        }
+    }
+    std::uint64_t sum = 0;
+    for (auto d : distance) sum += (d == unreached) ? 0 : d;
+    return sum;
+}
+
+std::uint64_t dijkstra_radix(const Graph & graph) {
+    std::vector<std::uint64_t> distance(graph.size(), unreached);
+    RadixHeap<std::uint32_t> queue;
+    distance[0] = 0;
+    queue.push(0, 0);
+    while (!queue.empty()) {
+        auto current = queue.top();
+        queue.pop();
+        if (current.first != distance[current.second]) continue;
+        for (auto && edge : graph[current.second]) {
+            auto d = current.first + edge.weight;
+            if (d < distance[edge.to]) {
+                distance[edge.to] = d;
+                queue.push(d, edge.to);
+            }
+        }
+    }
+    std::uint64_t sum = 0;
+    for (auto d : distance) sum += (d == unreached) ? 0 : d;
+    return sum;
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::size_t vertices = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::mt19937 gen(40);
+    std::vector<std::uint32_t> input(n);
+    for (auto && i : input) i = gen();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(34) << "method" << std::right << std::setw(12) << "ms" << std::endl;
+    std::cout << n << " pushes, then pops until empty" << std::endl;
+    report("std::priority_queue", time_ms([&] {
+        std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<std::uint32_t>> queue;
+        for (auto i : input) queue.push(i);
+        long long sum = 0;
+        while (!queue.empty()) {
+            sum += queue.top();
+            queue.pop();
+        }
+        sink = sum;
+    }));
+    push_pop<2>(input);
+    push_pop<4>(input);
+    push_pop<8>(input);
+    report("RadixHeap", time_ms([&] {
+        RadixHeap<char> queue;
+        for (auto i : input) queue.push(i, 0);
+        long long sum = 0;
+        while (!queue.empty()) {
+            sum += (long long)queue.top().first;
+            queue.pop();
+        }
+        sink = sum;
+    }));
+
+    std::cout << n << " elements built into a heap at once" << std::endl;
+    report("std::priority_queue(first, last)", time_ms([&] {
+        std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<std::uint32_t>> queue(input.begin(), input.end());
+        sink = queue.top();
+    }));
+    build<2>(input);
+    build<4>(input);
+
+    Graph graph(vertices);
+    for (std::size_t v = 0; v < vertices; ++v) {
+        for (int e = 0; e < 8; ++e) graph[v].push_back({ std::uint32_t(gen() % vertices), std::uint32_t(gen() % 1000 + 1) });
+    }
+    std::cout << "dijkstra, " << vertices << " vertices, " << 8 * vertices << " edges" << std::endl;
+    std::uint64_t expected = 0, result = 0;
+    report("std::priority_queue, lazy", time_ms([&] { expected = dijkstra_std(graph); }));
+    report("PriorityQueue<2>, decrease_key", time_ms([&] { result = dijkstra_addressable<2>(graph); }));
+    if (result != expected) std::cout << "  wrong result" << std::endl;
+    report("PriorityQueue<4>, decrease_key", time_ms([&] { result = dijkstra_addressable<4>(graph); }));
+    if (result != expected) std::cout << "  wrong result" << std::endl;
+    report("RadixHeap, lazy", time_ms([&] { result = dijkstra_radix(graph); }));
+    if (result != expected) std::cout << "  wrong result" << std::endl;
+}
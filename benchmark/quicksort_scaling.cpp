@@ -0,0 +1,60 @@
+// parallel_quicksort on 1, 2, 4 ... threads against the single-threaded kernels, all in place.
+// quicksort itself only runs on random input: it goes quadratic on the others
+// usage: quicksort_scaling [elements] [max threads] [grain]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "distributions.h"
+#include "../sort/parallel_quicksort.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Function>
+double time_ms(const std::vector<int> & input, Function function) {
+    auto vec = input;
+    auto start = std::chrono::steady_clock::now();
+    function(vec);
+    auto stop = std::chrono::steady_clock::now();
+    for (std::size_t i = 1; i < vec.size(); ++i) {
+        if (vec[i] < vec[i - 1]) return -1;
+    }
+    sink = vec.front();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void report(const std::string & method, unsigned threads, double ms, double baseline) {
+    std::cout << std::left << std::setw(24) << method << std::right << std::setw(8) << threads;
+    if (ms < 0) std::cout << std::setw(12) << "wrong result" << std::endl;
+    else std::cout << std::setw(12) << ms << std::setw(10) << baseline / ms << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+    int n = (argc > 1) ? std::atoi(argv[1]) : 20000000;
+    unsigned max_threads = (argc > 2) ? unsigned(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+    int grain = (argc > 3) ? std::atoi(argv[3]) : 16384;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " ints, grain " << grain << std::endl;
+    for (auto distribution : { Distributions::random, Distributions::sorted, Distributions::few_unique }) {
+        auto input = generate<int>(distribution, std::size_t(n), 0, 38);
+        std::cout << distribution_name(distribution, 0) << std::endl;
+        std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(8) << "threads"
+                  << std::setw(12) << "ms" << std::setw(10) << "speedup" << std::endl;
+        auto baseline = time_ms(input, [](std::vector<int> & vec) { bounded_quicksort(vec, 0, int(vec.size()) - 1); });
+        if (distribution == Distributions::random) {
+            report("quicksort", 1, time_ms(input, [](std::vector<int> & vec) { quicksort(vec, 0, int(vec.size()) - 1); }), baseline);
+        }
+        report("bounded_quicksort", 1, baseline, baseline);
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            report("parallel_quicksort", threads, time_ms(input, [&](std::vector<int> & vec) {
+                parallel_quicksort(vec, 0, int(vec.size()) - 1, threads, grain);
+            }), baseline);
+        }
+    }
+}
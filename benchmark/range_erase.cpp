@@ -0,0 +1,79 @@
+// deleting every key below a cutoff: remove() per key against truncate_below(), and a middle
+// slice against erase_range(), on the AVL and red-black trees
+// usage: range_erase [keys] [percent erased]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../tree/avl_tree.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Function>
+double time_ms(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void report(const std::string & tree, const std::string & method, double ms, std::size_t left) {
+    std::cout << std::left << std::setw(12) << tree << std::setw(20) << method << std::right
+              << std::setw(12) << ms << std::setw(12) << left << std::endl;
+}
+
+template <typename Tree>
+void measure(const std::string & name, const std::vector<std::uint64_t> & keys, std::uint64_t cutoff) {
+    auto sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    {
+        Tree tree;
+        for (auto k : keys) tree.insert(k);
+        auto ms = time_ms([&] {
+            for (auto k : sorted) {
+                if (k >= cutoff) break;
+                tree.remove(k);
+            }
+        });
+        report(name, "remove per key", ms, tree.size());
+    }
+    {
+        Tree tree;
+        for (auto k : keys) tree.insert(k);
+        auto ms = time_ms([&] { tree.truncate_below(cutoff); });
+        report(name, "truncate_below", ms, tree.size());
+    }
+    {
+        // the same count of keys, from the middle of the key space
+        Tree tree;
+        for (auto k : keys) tree.insert(k);
+        auto low = (std::uint64_t(4) * keys.size() - cutoff) / 2;
+        auto ms = time_ms([&] { tree.erase_range(low, low + cutoff - 1); });
+        report(name, "erase_range", ms, tree.size());
+        sink = (long long)tree.size();
+    }
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    unsigned percent = (argc > 2) ? unsigned(std::atoi(argv[2])) : 50;
+    std::mt19937_64 gen(44);
+    std::vector<std::uint64_t> keys(n);
+    for (auto && k : keys) k = gen() % (4 * n);
+    auto cutoff = std::uint64_t(4) * n * percent / 100;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " random keys, erasing " << percent << "% of the key space" << std::endl;
+    std::cout << std::left << std::setw(12) << "tree" << std::setw(20) << "method" << std::right
+              << std::setw(12) << "ms" << std::setw(12) << "left" << std::endl;
+    measure<AVLTree<std::uint64_t>>("avl", keys, cutoff);
+    measure<RedBlackTree<std::uint64_t>>("red-black", keys, cutoff);
+}
@@ -0,0 +1,97 @@
+// sorting 256-byte records by moving them, by argsort, and by argsort over cached key prefixes
+// usage: record_sort [records]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "../sort/argsort.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+struct Record {
+    std::uint64_t key;
+    char name[24];
+    char payload[224];
+
+    bool operator<(const Record & rhs) const { return key < rhs.key; }
+    bool operator<=(const Record & rhs) const { return key <= rhs.key; }
+    bool operator>(const Record & rhs) const { return key > rhs.key; }
+    bool operator>=(const Record & rhs) const { return key >= rhs.key; }
+};
+
+struct KeyOf { std::uint64_t operator()(const Record & r) const { return r.key; } };
+struct NameOf { std::string operator()(const Record & r) const { return std::string(r.name, sizeof(r.name)); } };
+
+template <typename Function>
+double time_ms(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+template <typename Less>
+bool sorted(const std::vector<Record> & records, Less less) {
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        if (less(records[i], records[i - 1])) return false;
+    }
+    return true;
+}
+
+void report(const std::string & method, double ms, bool correct) {
+    std::cout << std::left << std::setw(34) << method << std::right << std::setw(12) << ms
+              << (correct ? "" : "  wrong result") << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::mt19937_64 gen(35);
+    std::vector<Record> input(n);
+    for (auto && r : input) {
+        r.key = gen();
+        std::snprintf(r.name, sizeof(r.name), "%014llu-customer", (unsigned long long)(gen() % 100000000000000ull));
+        std::memset(r.payload, int(r.key & 0xff), sizeof(r.payload));
+    }
+    auto by_key = [](const Record & a, const Record & b) { return a.key < b.key; };
+    auto by_name = [](const Record & a, const Record & b) { return std::memcmp(a.name, b.name, sizeof(a.name)) < 0; };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " records of " << sizeof(Record) << " bytes" << std::endl;
+    std::cout << std::left << std::setw(34) << "method" << std::right << std::setw(12) << "ms" << std::endl;
+
+    auto records = input;
+    // arguments are evaluated in no particular order, so each time is taken before its check
+    auto ms = time_ms([&] { sort(records); });
+    report("sort() on the records", ms, sorted(records, by_key));
+
+    records = input;
+    std::vector<std::size_t> perm;
+    ms = time_ms([&] { perm = argsort(records, KeyOf()); });
+    report("argsort", ms, true);
+    auto apply = time_ms([&] { apply_permutation(records, perm, 1); });
+    report("  apply, one at a time", apply, sorted(records, by_key));
+    records = input;
+    apply = time_ms([&] { apply_permutation(records, perm); });
+    report("  apply, blocks of 64", apply, sorted(records, by_key));
+
+    records = input;
+    ms = time_ms([&] { perm = argsort_prefix<KeyOf>(records); });
+    report("argsort_prefix", ms, true);
+
+    records = input;
+    ms = time_ms([&] { perm = argsort(records, NameOf()); });
+    apply_permutation(records, perm);
+    report("argsort by name, full keys", ms, sorted(records, by_name));
+    records = input;
+    ms = time_ms([&] { perm = argsort_prefix<NameOf>(records); });
+    apply_permutation(records, perm);
+    report("argsort by name, prefixes", ms, sorted(records, by_name));
+    sink = (long long)perm.size();
+}
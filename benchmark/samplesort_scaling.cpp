@@ -0,0 +1,69 @@
+// sample sort on 1, 2, 4 ... threads and worker processes, against sort() and mergesort on one core
+// usage: samplesort_scaling [elements] [max workers]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "distributions.h"
+#include "../sort/samplesort.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+// a record whose key is not an integer, so sort() cannot fall back on radix sort
+struct Item {
+    double key;
+    long payload;
+
+    bool operator<(const Item & rhs) const { return key < rhs.key; }
+    bool operator<=(const Item & rhs) const { return key <= rhs.key; }
+    bool operator>(const Item & rhs) const { return key > rhs.key; }
+    bool operator>=(const Item & rhs) const { return key >= rhs.key; }
+};
+
+template <typename Function>
+double time_ms(const std::vector<Item> & input, Function function) {
+    auto vec = input;
+    auto start = std::chrono::steady_clock::now();
+    function(vec);
+    auto stop = std::chrono::steady_clock::now();
+    for (std::size_t i = 1; i < vec.size(); ++i) {
+        if (vec[i] < vec[i - 1]) return -1;
+    }
+    sink = vec.front().payload;
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void report(const std::string & method, unsigned workers, double ms, double baseline) {
+    std::cout << std::left << std::setw(24) << method << std::right << std::setw(8) << workers;
+    if (ms < 0) std::cout << std::setw(12) << "wrong result" << std::endl;
+    else std::cout << std::setw(12) << ms << std::setw(10) << baseline / ms << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+    unsigned max_workers = (argc > 2) ? unsigned(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+    auto keys = generate<int>(Distributions::random, n, 0, 37);
+    std::vector<Item> input(n);
+    for (std::size_t i = 0; i < n; ++i) input[i] = { keys[i] / 7.0, long(i) };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << n << " elements of " << sizeof(Item) << " bytes" << std::endl;
+    std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(8) << "workers"
+              << std::setw(12) << "ms" << std::setw(10) << "speedup" << std::endl;
+    auto baseline = time_ms(input, [](std::vector<Item> & vec) { sort(vec); });
+    report("sort()", 1, baseline, baseline);
+    report("mergesort", 1, time_ms(input, [](std::vector<Item> & vec) {
+        std::vector<Item> temp(vec.size());
+        mergesort(vec, 0, int(vec.size()) - 1, temp);
+    }), baseline);
+    for (unsigned workers = 1; workers <= max_workers; workers *= 2) {
+        report("samplesort, threads", workers, time_ms(input, [&](std::vector<Item> & vec) { samplesort(vec, workers); }), baseline);
+        report("  stable", workers, time_ms(input, [&](std::vector<Item> & vec) { samplesort(vec, workers, true); }), baseline);
+        report("  processes", workers, time_ms(input, [&](std::vector<Item> & vec) { process_samplesort(vec, workers); }), baseline);
+    }
+}
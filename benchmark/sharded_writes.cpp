@@ -0,0 +1,76 @@
+// insert throughput of ShardedTree over uniform keys as the shard count grows, one writer per shard,
+// against a single RedBlackTree behind one mutex
+// usage: sharded_writes [inserts per thread] [max shards]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../tree/sharded_tree.h"
+#include "../tree/avl_tree.h"
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+template <typename Insert>
+double run_ms(unsigned threads, std::size_t inserts, Insert insert) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 gen(42 + t);
+            long long inserted = 0;
+            for (std::size_t i = 0; i < inserts; ++i) inserted += insert(std::uint32_t(gen()));
+            sink = inserted;
+        });
+    }
+    for (auto && worker : workers) worker.join();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// shards ranges of equal width over the 32-bit key space
+std::vector<std::uint32_t> even_bounds(unsigned shards) {
+    std::vector<std::uint32_t> bounds;
+    for (unsigned i = 1; i < shards; ++i) bounds.push_back(std::uint32_t((std::uint64_t(1) << 32) * i / shards));
+    return bounds;
+}
+
+void report(const std::string & method, unsigned shards, std::size_t total, double ms, double baseline) {
+    std::cout << std::left << std::setw(16) << method << std::right << std::setw(8) << shards
+              << std::setw(12) << double(total) / ms / 1000 << std::setw(10) << baseline / ms << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t inserts = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 500000;
+    unsigned max_shards = (argc > 2) ? unsigned(std::atoi(argv[2])) : 2 * std::thread::hardware_concurrency();
+    if (max_shards == 0) max_shards = 1;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << inserts << " uniform inserts per writer, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+    std::cout << std::left << std::setw(16) << "structure" << std::right << std::setw(8) << "shards"
+              << std::setw(12) << "Mops" << std::setw(10) << "speedup" << std::endl;
+    for (unsigned shards = 1; shards <= max_shards; shards *= 2) {
+        std::size_t total = std::size_t(shards) * inserts;
+        // the baseline per row: as many writers, one lock
+        RedBlackTree<std::uint32_t> single;
+        std::mutex mutex;
+        auto baseline = run_ms(shards, inserts, [&](std::uint32_t key) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return single.insert(key);
+        });
+        report("locked rb", shards, total, baseline, baseline);
+
+        // the bounds are right for uniform keys, so rebalancing stays off
+        ShardedTree<std::uint32_t> rb(even_bounds(shards), 0);
+        report("sharded rb", shards, total, run_ms(shards, inserts, [&](std::uint32_t key) { return rb.insert(key); }), baseline);
+        ShardedTree<std::uint32_t, AVLTree<std::uint32_t>> avl(even_bounds(shards), 0);
+        report("sharded avl", shards, total, run_ms(shards, inserts, [&](std::uint32_t key) { return avl.insert(key); }), baseline);
+    }
+}
@@ -0,0 +1,177 @@
+// load generator for tree_server: one thread per connection, each keeping `depth` requests in
+// flight, drawn from a mix of finds, inserts, removes and ranges over uniform keys. prints the
+// throughput and the round-trip latency of a request at p50, p99 and p99.9
+// usage: tree_load [-s socket] [-c connections] [-d depth] [-n requests per connection]
+//                  [-k key space] [-f find %] [-r range %] [-w range width]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include "../tree/tree_protocol.h"
+
+// keeps the responses from being optimized away
+volatile long long sink;
+
+struct LoadOptions {
+    std::string path = default_socket_path;
+    std::size_t connections = 4;
+    std::size_t depth = 16;
+    std::size_t requests = 200000;
+    std::int64_t key_space = 1000000;
+    unsigned find_percent = 80;
+    unsigned range_percent = 5;
+    std::int64_t range_width = 100;
+};
+
+struct ClientResult {
+    std::vector<double> latency_us;
+    long long hits = 0;
+};
+
+void write_all(int fd, const char * data, std::size_t size) {
+    while (size) {
+        auto count = ::write(fd, data, size);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("write to the server failed");
+        }
+        data += count;
+        size -= std::size_t(count);
+    }
+}
+
+Request next_request(const LoadOptions & options, std::mt19937_64 & gen, std::uint32_t id) {
+    Request request = {};
+    request.id = id;
+    request.key = std::int64_t(gen() % std::uint64_t(options.key_space));
+    auto roll = unsigned(gen() % 100);
+    if (roll < options.find_percent) request.op = Ops::find;
+    else if (roll < options.find_percent + options.range_percent) {
+        request.op = Ops::range;
+        request.high = request.key + options.range_width - 1;
+    }
+    // the rest split evenly, so the tree holds its size
+    else request.op = (gen() % 2) ? Ops::insert : Ops::remove;
+    return request;
+}
+
+void client(const LoadOptions & options, unsigned seed, ClientResult & result) {
+    using clock = std::chrono::steady_clock;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    auto address = socket_address(options.path);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+        throw std::runtime_error("cannot connect to " + options.path);
+
+    std::mt19937_64 gen(seed);
+    std::deque<clock::time_point> sent_at;
+    std::vector<Request> burst;
+    std::vector<char> in;
+    std::size_t sent = 0, received = 0;
+    std::uint32_t expected = 0;
+    char buffer[1 << 16];
+    result.latency_us.reserve(options.requests);
+
+    while (received < options.requests) {
+        // top the window up in one write
+        burst.clear();
+        while (sent + burst.size() < options.requests && sent - received + burst.size() < options.depth)
+            burst.push_back(next_request(options, gen, std::uint32_t(sent + burst.size())));
+        if (!burst.empty()) {
+            auto now = clock::now();
+            sent_at.insert(sent_at.end(), burst.size(), now);
+            write_all(fd, reinterpret_cast<const char *>(burst.data()), burst.size() * sizeof(Request));
+            sent += burst.size();
+        }
+
+        auto count = ::read(fd, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) throw std::runtime_error("the server closed the connection");
+        auto now = clock::now();
+        in.insert(in.end(), buffer, buffer + count);
+
+        std::size_t offset = 0;
+        while (offset + sizeof(Response) <= in.size()) {
+            Response response;
+            std::memcpy(&response, in.data() + offset, sizeof(response));
+            auto size = sizeof(Response) + std::size_t(response.count) * sizeof(std::int64_t);
+            if (offset + size > in.size()) break;
+            if (response.id != expected++) throw std::runtime_error("responses out of order");
+            result.hits += response.status;
+            result.latency_us.push_back(std::chrono::duration<double, std::micro>(now - sent_at.front()).count());
+            sent_at.pop_front();
+            ++received;
+            offset += size;
+        }
+        in.erase(in.begin(), in.begin() + std::ptrdiff_t(offset));
+    }
+    ::close(fd);
+}
+
+int main(int argc, char * argv[]) {
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i) {
+        auto more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "-s") && more) options.path = argv[++i];
+        else if (!std::strcmp(argv[i], "-c") && more) options.connections = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-d") && more) options.depth = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-n") && more) options.requests = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-k") && more) options.key_space = std::strtoll(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-f") && more) options.find_percent = unsigned(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-r") && more) options.range_percent = unsigned(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-w") && more) options.range_width = std::strtoll(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "usage: tree_load [-s socket] [-c connections] [-d depth] [-n requests per connection]" << std::endl
+                      << "                 [-k key space] [-f find %] [-r range %] [-w range width]" << std::endl;
+            return 1;
+        }
+    }
+    if (options.connections == 0 || options.depth == 0 || options.key_space <= 0 || options.find_percent + options.range_percent > 100) {
+        std::cerr << "tree_load: bad options" << std::endl;
+        return 1;
+    }
+
+    std::vector<ClientResult> results(options.connections);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed(false);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t c = 0; c < options.connections; ++c) {
+        threads.emplace_back([&, c] {
+            try {
+                client(options, unsigned(48 + c), results[c]);
+            }
+            catch (const std::exception & e) {
+                std::cerr << e.what() << std::endl;
+                failed = true;
+            }
+        });
+    }
+    for (auto && thread : threads) thread.join();
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failed) return 1;
+
+    std::vector<double> latency_us;
+    long long hits = 0;
+    for (auto && result : results) {
+        latency_us.insert(latency_us.end(), result.latency_us.begin(), result.latency_us.end());
+        hits += result.hits;
+    }
+    sink = hits;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << options.connections << " connections, depth " << options.depth << ", " << latency_us.size() << " requests in "
+              << seconds << " s" << std::endl;
+    std::cout << std::left << std::setw(14) << "requests/s" << std::right << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "p99.9 us" << std::endl;
+    std::cout << std::left << std::setw(14) << double(latency_us.size()) / seconds << std::right << std::setw(10) << percentile(latency_us, 0.5)
+              << std::setw(10) << percentile(latency_us, 0.99) << std::setw(10) << percentile(latency_us, 0.999) << std::endl;
+}
@@ -0,0 +1,92 @@
+// lookup cost of the balanced trees against the splay tree on Zipf-distributed keys
+// usage: zipf_lookup [keys] [lookups]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdlib>
+
+#include "../tree/avl_tree.h"
+#include "../tree/RedBlackTree/RedBlackTree/red_black_tree.h"
+#include "../tree/splay_tree.h"
+#include "distributions.h"
+
+// number of edges between the root and key, read straight off the public root
+template <typename NodePtr, typename Key>
+unsigned depth(NodePtr node, const Key & key) {
+    unsigned d = 0;
+    while (node && node->key != key) {
+        node = (key < node->key) ? node->left : node->right;
+        ++d;
+    }
+    return d;
+}
+
+// keeps the timed loops from being optimized away
+volatile long long sink;
+
+struct Result {
+    double depth;
+    double ns;
+};
+
+template <typename Tree>
+Result run(const std::vector<int> & keys, const std::vector<int> & lookups) {
+    Tree tree;
+    for (auto && k : keys) { tree.insert(k); }
+
+    // the depth pass also warms the splay tree up to its steady state
+    unsigned long long total_depth = 0;
+    for (auto && k : lookups) {
+        total_depth += depth(tree.root, k);
+        tree.find(k);
+    }
+
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto && k : lookups) {
+        auto node = tree.find(k);
+        if (node) checksum += node->key;
+    }
+    auto stop = std::chrono::steady_clock::now();
+    sink = checksum;
+
+    auto ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    return { double(total_depth) / lookups.size(), ns / lookups.size() };
+}
+
+int main(int argc, char * argv[]) {
+    std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t m = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::mt19937_64 gen(12345);
+
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    // rank r maps to keys[r], so hot keys are scattered over the key space
+
+    std::cout << std::left << std::setw(8) << "skew" << std::setw(14) << "tree"
+              << std::right << std::setw(12) << "depth" << std::setw(12) << "ns/lookup" << std::endl;
+    for (double skew : { 0.0, 0.5, 0.8, 0.99, 1.2, 1.5 }) {
+        ZipfSampler zipf(n, skew);
+        std::vector<int> lookups(m);
+        // the sampler's ranks start at 1
+        for (auto && k : lookups) { k = keys[zipf(gen) - 1]; }
+
+        std::vector<std::pair<std::string, Result>> results = {
+            { "avl", run<AVLTree<int>>(keys, lookups) },
+            { "red-black", run<RedBlackTree<int>>(keys, lookups) },
+            { "splay", run<SplayTree<int>>(keys, lookups) },
+        };
+        for (auto && r : results) {
+            std::cout << std::left << std::setw(8) << skew << std::setw(14) << r.first
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << r.second.depth << std::setw(12) << r.second.ns << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "argsort.h"
+
+struct Record {
+    int key;
+    std::string name;
+};
+
+int main() {
+    std::cout << "Input key name pairs here: " << std::endl;
+    std::vector<Record> records;
+    Record record;
+    while (std::cin >> record.key >> record.name) {
+        records.push_back(record);
+    }
+    auto perm = argsort(records, [](const Record & r) { return r.key; });
+    std::cout << "permutation: ";
+    for (auto && i : perm) { std::cout << i << " "; }
+    std::cout << std::endl;
+
+    apply_permutation(records, perm);
+    for (auto && r : records) { std::cout << r.key << " " << r.name << std::endl; }
+}
@@ -0,0 +1,179 @@
+#ifndef ARGSORT_H
+#define ARGSORT_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "sort.h"
+
+// what the kernels move instead of records: the key and where the record is.
+// ties on the key fall back to the index, so the order is stable whichever
+// kernel runs
+template <typename Key>
+struct KeyIndex {
+    Key key;
+    std::size_t index;
+
+    int compare(const KeyIndex & rhs) const {
+        if (key < rhs.key) return -1;
+        if (rhs.key < key) return 1;
+        return (index < rhs.index) ? -1 : (rhs.index < index);
+    }
+    bool operator<(const KeyIndex & rhs) const { return compare(rhs) < 0; }
+    bool operator<=(const KeyIndex & rhs) const { return compare(rhs) <= 0; }
+    bool operator>(const KeyIndex & rhs) const { return compare(rhs) > 0; }
+    bool operator>=(const KeyIndex & rhs) const { return compare(rhs) >= 0; }
+    bool operator==(const KeyIndex & rhs) const { return compare(rhs) == 0; }
+    bool operator!=(const KeyIndex & rhs) const { return compare(rhs) != 0; }
+};
+
+// the permutation that sorts records by key_of(record): perm[i] is the index
+// of the record that belongs at position i. records are read once, to pull
+// the keys out, and never moved; `sorter` is any kernel over a whole vector
+template <typename Record, typename KeyOf, typename Sorter>
+std::vector<std::size_t> argsort(const std::vector<Record> & records, KeyOf key_of, Sorter sorter) {
+    using Key = typename std::decay<decltype(key_of(records[0]))>::type;
+    std::vector<KeyIndex<Key>> pairs;
+    pairs.reserve(records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) pairs.push_back({ key_of(records[i]), i });
+    sorter(pairs);
+    std::vector<std::size_t> perm(records.size());
+    for (std::size_t i = 0; i < pairs.size(); ++i) perm[i] = pairs[i].index;
+    return perm;
+}
+
+template <typename Record, typename KeyOf>
+std::vector<std::size_t> argsort(const std::vector<Record> & records, KeyOf key_of) {
+    return argsort(records, key_of, [](auto & pairs) { sort(pairs); });
+}
+
+// an order-preserving 64-bit image of the leading part of a key: equal
+// prefixes mean the keys may still differ, unless the key fits whole
+inline std::uint64_t key_prefix(const std::string & key) {
+    std::uint64_t prefix = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | ((i < key.size()) ? std::uint8_t(key[i]) : 0);
+    }
+    return prefix;
+}
+
+template <typename Key>
+typename std::enable_if<std::is_integral<Key>::value, std::uint64_t>::type key_prefix(const Key & key) {
+    static_assert(sizeof(Key) <= 8, "integer keys wider than 64 bits have no prefix");
+    // the sign bit flipped, so negatives order first
+    auto value = std::uint64_t(std::int64_t(key));
+    return std::is_signed<Key>::value ? value ^ (std::uint64_t(1) << 63) : value;
+}
+
+template <typename Key>
+typename std::enable_if<std::is_floating_point<Key>::value, std::uint64_t>::type key_prefix(const Key & key) {
+    // negatives have every bit flipped, positives only the sign bit
+    double value = key;
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits ^ (std::uint64_t(1) << 63);
+}
+
+// arithmetic keys fit their prefix whole, so equal prefixes are equal keys
+template <typename Key>
+struct prefix_is_exact : std::integral_constant<bool, std::is_arithmetic<Key>::value> {};
+
+// the entry of the key-prefix mode: comparisons read only the cached prefix
+// and, when two prefixes tie on a key that does not fit, the two records.
+// KeyOf is a function object type, default-constructed like a tree's Compare
+template <typename Record, typename KeyOf>
+struct PrefixEntry {
+    std::uint64_t prefix;
+    const Record * record;
+
+    int compare(const PrefixEntry & rhs) const {
+        if (prefix != rhs.prefix) return (prefix < rhs.prefix) ? -1 : 1;
+        using Key = typename std::decay<decltype(KeyOf()(*record))>::type;
+        if (!prefix_is_exact<Key>::value) {
+            KeyOf key_of;
+            const auto & lhs_key = key_of(*record);
+            const auto & rhs_key = key_of(*rhs.record);
+            if (lhs_key < rhs_key) return -1;
+            if (rhs_key < lhs_key) return 1;
+        }
+        return (record < rhs.record) ? -1 : (rhs.record < record);
+    }
+    bool operator<(const PrefixEntry & rhs) const { return compare(rhs) < 0; }
+    bool operator<=(const PrefixEntry & rhs) const { return compare(rhs) <= 0; }
+    bool operator>(const PrefixEntry & rhs) const { return compare(rhs) > 0; }
+    bool operator>=(const PrefixEntry & rhs) const { return compare(rhs) >= 0; }
+    bool operator==(const PrefixEntry & rhs) const { return compare(rhs) == 0; }
+    bool operator!=(const PrefixEntry & rhs) const { return compare(rhs) != 0; }
+};
+
+// argsort with 16-byte entries whatever the key: for keys that are long or
+// costly to copy, such as strings
+template <typename KeyOf, typename Record, typename Sorter>
+std::vector<std::size_t> argsort_prefix(const std::vector<Record> & records, Sorter sorter) {
+    KeyOf key_of;
+    std::vector<PrefixEntry<Record, KeyOf>> entries;
+    entries.reserve(records.size());
+    for (auto && record : records) entries.push_back({ key_prefix(key_of(record)), &record });
+    sorter(entries);
+    std::vector<std::size_t> perm(records.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) perm[i] = std::size_t(entries[i].record - records.data());
+    return perm;
+}
+
+template <typename KeyOf, typename Record>
+std::vector<std::size_t> argsort_prefix(const std::vector<Record> & records) {
+    return argsort_prefix<KeyOf>(records, [](auto & entries) { sort(entries); });
+}
+
+inline void prefetch(const void * address, std::size_t bytes) {
+#if defined(__GNUC__)
+    auto first = static_cast<const char *>(address);
+    for (std::size_t offset = 0; offset < bytes; offset += 64) __builtin_prefetch(first + offset);
+#else
+    (void)address;
+    (void)bytes;
+#endif
+}
+
+// rearranges vec in place so that vec[i] becomes the old vec[perm[i]].
+// destinations are filled in order, a block at a time: the block's sources
+// are prefetched together first, so their cache misses overlap instead of
+// being paid one after another, and each record is then swapped straight
+// into place. `where` and `who` track which record sits where, 2n indices
+template <typename T>
+void apply_permutation(std::vector<T> & vec, const std::vector<std::size_t> & perm, std::size_t block = 64) {
+    auto n = vec.size();
+    std::vector<std::size_t> where(n), who(n);  // original index -> position, position -> original index
+    for (std::size_t i = 0; i < n; ++i) where[i] = who[i] = i;
+    if (block == 0) block = 1;
+
+    for (std::size_t first = 0; first < n; first += block) {
+        auto last = (first + block < n) ? first + block : n;
+        for (auto i = first; i < last; ++i) prefetch(&vec[where[perm[i]]], sizeof(T));
+        for (auto i = first; i < last; ++i) {
+            auto wanted = perm[i];
+            auto from = where[wanted];
+            if (from == i) continue;
+            std::swap(vec[i], vec[from]);
+            // the record that was at i now lives where the wanted one was
+            auto displaced = who[i];
+            who[from] = displaced;
+            where[displaced] = from;
+            who[i] = wanted;
+            where[wanted] = i;
+        }
+    }
+}
+
+// sorts records by key through argsort: the kernels move (key, index) pairs,
+// and each record is swapped into place once, when the permutation is applied
+template <typename Record, typename KeyOf>
+void sort_by_key(std::vector<Record> & records, KeyOf key_of) {
+    apply_permutation(records, argsort(records, key_of));
+}
+
+#endif
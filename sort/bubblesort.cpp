@@ -1,7 +1,7 @@
 #include <iostream>
 #include <vector>
 
-void bubblesort(std::vector<int>& vec);
+#include "bubblesort.h"
 
 int main() {
     std::vector<int> vec;
@@ -12,16 +12,3 @@ int main() {
         std::cout << i << " ";
     }
 }
-
-void bubblesort(std::vector<int> & vec) {
-    bool flag = false;
-    while (!flag) {
-        flag = true;
-        for(int i = 1; i < vec.size(); ++i) {
-            if (vec[i - 1] > vec[i]) {
-                flag = false;
-                std::swap(vec[i - 1], vec[i]);
-            }
-        }
-    }
-}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef BUBBLESORT_H
+#define BUBBLESORT_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+template <typename T>
+void bubblesort(std::vector<T> & vec) {
+    bool flag = false;
+    while (!flag) {
+        flag = true;
+        for (std::size_t i = 1; i < vec.size(); ++i) {
+            if (vec[i - 1] > vec[i]) {
+                flag = false;
+                std::swap(vec[i - 1], vec[i]);
+            }
+        }
+    }
+}
+
+#endif
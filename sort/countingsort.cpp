@@ -0,0 +1,14 @@
+#include <iostream>
+#include <vector>
+
+#include "countingsort.h"
+
+int main() {
+    int num;
+    std::vector<int> vec;
+    while (std::cin >> num) {
+        vec.emplace_back(num);
+    }
+    if (!countingsort(vec, 1 << 24)) std::cout << "range too wide" << std::endl;
+    for (auto && i : vec) { std::cout << i << " "; }
+}
@@ -0,0 +1,32 @@
+#ifndef COUNTINGSORT_H
+#define COUNTINGSORT_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+// for integer keys in a narrow range: one pass to count each value, one to
+// write them back out, O(n + range) with no comparisons between elements.
+// returns false, leaving vec untouched, when max - min + 1 exceeds max_range
+template <typename T>
+bool countingsort(std::vector<T> & vec, std::size_t max_range) {
+    static_assert(std::is_integral<T>::value, "countingsort needs integer keys");
+    if (vec.size() < 2) return true;
+    auto bounds = std::minmax_element(vec.begin(), vec.end());
+    auto low = *bounds.first;
+    // the difference is taken unsigned so that a full-width range cannot overflow
+    using U = typename std::make_unsigned<T>::type;
+    auto range = std::size_t(U(U(*bounds.second) - U(low)));
+    if (range >= max_range) return false;
+
+    std::vector<std::size_t> counts(range + 1);
+    for (auto && i : vec) ++counts[std::size_t(U(U(i) - U(low)))];
+    std::size_t k = 0;
+    for (std::size_t value = 0; value <= range; ++value) {
+        for (auto count = counts[value]; count > 0; --count) vec[k++] = T(U(low) + U(value));
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef HEAPSORT_H
+#define HEAPSORT_H
+
+#include <vector>
+#include <utility>
+#include <functional>
+
+// `comp` orders the heap: the top is the largest by comp, so std::greater
+// turns every function here into its min-heap counterpart
+template <typename T, typename Compare = std::less<T>> void heapSort(std::vector<T> & vec, int last, Compare comp = Compare());
+template <typename T, typename Compare = std::less<T>> void maxHeapify(std::vector<T>& vec, int parent, int last, Compare comp = Compare());
+template <typename T, typename Compare = std::less<T>> void floydHeapify(std::vector<T> & vec, int last, Compare comp = Compare());
+
+template <typename T, typename Compare>
+void heapSort(std::vector<T> & vec, int last, Compare comp) {
+    // building the heap
+
+    for (int i = last / 2; i > 0; --i) {
+        maxHeapify(vec, i, last, comp);
+    }
+
+    while (last > 1) {
+        std::swap(vec[1], vec[last]);
+        // the biggest value is now at the end of the array
+        --last;
+        floydHeapify(vec, last, comp);  // or maxHeapify(vec, 1, last, comp);
+        // the next biggest value is now at the beginning of the array
+    }
+}
+
+// to heapify the tree to be in the maximum heap format
+template <typename T, typename Compare>
+void maxHeapify(std::vector<T>& vec, int parent, int last, Compare comp) {
+    int child = 2 * parent; // child is an index to a left child
+    while (child <= last) {
+        // child + 1 is a right child
+        // child + 1 <= last: the parent has a right child
+        // vec[child + 1] > vec[child] the right child is larger than the left child
+        if (child + 1 <= last && comp(vec[child], vec[child + 1])) ++child;
+
+        // child is now the right child, if it has one;
+        // otherwise it's the left child
+        // if the parent is smaller than the child, swap the parent and the child
+        if (comp(vec[parent], vec[child])) std::swap(vec[child], vec[parent]);
+
+        // parent is now child
+        parent = child;
+
+        // child is now child's child
+        child = 2 * parent;
+
+        // if child is not smaller than last, the child will go through the loop
+    }
+}
+
+template <typename T, typename Compare>
+void floydHeapify(std::vector<T> & vec, int last, Compare comp) {
+    int parent = 1, child = 2;
+    while (child <= last) {
+        // 1st condition: child + 1 is the right child ( if it has a right child )
+        // 2nd condition: if the left child is smaller than the right child
+        // if it has a right child, and the left child is smaller, child is now the right child
+        if (child + 1 <= last && comp(vec[child], vec[child + 1])) ++child;
+
+        // swap the parent and the 'bigger' child
+        std::swap(vec[parent], vec[child]);
+
+        // reheapify the child if need be
+        parent = child;
+
+        child = 2 * parent;
+    }
+    // this round is over
+
+    // 2nd condition: while the current parent is bigger than its parent
+    while (parent > 1 && comp(vec[parent / 2], vec[parent])) {
+        std::swap(vec[parent], vec[parent / 2]);
+        parent = parent / 2;
+    }
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef INSERTIONSORT_H
+#define INSERTIONSORT_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+template <typename T>
+void insertionsort(std::vector<T> & vec) {
+    for (std::size_t i = 1; i < vec.size(); ++i) {
+        auto pivot = vec[i];  // the value next to the sorted list
+        auto j = std::ptrdiff_t(i) - 1;  // j is the index of the largest number in the sorted list, signed to reach -1
+        for (; j >= 0 && vec[j] > pivot; --j) {  // find the pos of value that's smaller than the pivot
+            vec[j + 1] = vec[j]; // move the list one position to the next to make way for the pivot
+        }
+        // the space has been made
+        // smaller _____ larger
+        //   j    j + 1  j + 2 ...
+        vec[j + 1] = pivot; // insert the pivot right after the said value
+    }
+}
+
+// sorts vec[low..high] in place; for the short ranges that selection and
+// bounded_quicksort end on
+template <typename T>
+void insertionsort(std::vector<T> & vec, int low, int high) {
+    for (int i = low + 1; i <= high; ++i) {
+        auto pivot = vec[i];
+        auto j = i - 1;
+        for (; j >= low && vec[j] > pivot; --j) vec[j + 1] = vec[j];
+        vec[j + 1] = pivot;
+    }
+}
+
+#endif
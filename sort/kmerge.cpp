@@ -0,0 +1,103 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "kway_merge.h"
+
+// merges files of sorted integers, "-" being stdin. --unique drops repeats,
+// --count prints each distinct value with how often it appeared, and --sum
+// reads "key value" pairs and prints each key with the sum of its values
+struct KeyValue {
+    long long key;
+    long long value;
+};
+
+struct ByKey {
+    bool operator()(const KeyValue & lhs, const KeyValue & rhs) const { return lhs.key < rhs.key; }
+};
+
+class KeyValueReader {
+    NumberReader numbers;
+
+    public:
+    using value_type = KeyValue;
+    explicit KeyValueReader(const std::string & path) : numbers(path) {}
+    bool next(KeyValue & pair) {
+        if (!numbers.next(pair.key)) return false;
+        if (!numbers.next(pair.value)) throw std::runtime_error("a key without a value");
+        return true;
+    }
+};
+
+template <typename Reader>
+std::vector<Reader> open_all(const std::vector<std::string> & paths) {
+    std::vector<Reader> readers;
+    readers.reserve(paths.size());
+    for (auto && path : paths) readers.emplace_back(path);
+    return readers;
+}
+
+int main(int argc, char * argv[]) {
+    std::string mode, output;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--unique") || !std::strcmp(argv[i], "--count") || !std::strcmp(argv[i], "--sum")) mode = argv[i];
+        else if (!std::strcmp(argv[i], "-o") && i + 1 < argc) output = argv[++i];
+        else paths.emplace_back(argv[i]);
+    }
+    if (paths.empty()) {
+        std::cerr << "usage: kmerge [--unique | --count | --sum] [-o output] file..." << std::endl;
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file) {
+            std::cerr << "cannot open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream & out = output.empty() ? std::cout : file;
+
+    try {
+        if (mode == "--sum" || mode == "--count") {
+            std::vector<KeyValueReader> pairs;
+            std::vector<NumberReader> numbers;
+            auto print = [&](const KeyValue & pair) { out << pair.key << " " << pair.value << "\n"; };
+            auto add = [](KeyValue lhs, const KeyValue & rhs) { lhs.value += rhs.value; return lhs; };
+            if (mode == "--sum") {
+                pairs = open_all<KeyValueReader>(paths);
+                kway_merge_reduce(pairs, print, add, ByKey());
+            }
+            else {
+                // each value counts once
+                numbers = open_all<NumberReader>(paths);
+                long long last = 0, count = 0;
+                kway_merge(numbers, [&](long long value) {
+                    if (count && value != last) {
+                        print({ last, count });
+                        count = 0;
+                    }
+                    last = value;
+                    ++count;
+                });
+                if (count) print({ last, count });
+            }
+        }
+        else {
+            auto numbers = open_all<NumberReader>(paths);
+            auto print = [&](long long value) { out << value << "\n"; };
+            if (mode == "--unique") kway_merge_unique(numbers, print);
+            else kway_merge(numbers, print);
+        }
+    }
+    catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    out.flush();
+}
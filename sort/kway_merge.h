@@ -0,0 +1,257 @@
+#ifndef KWAY_MERGE_H
+#define KWAY_MERGE_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <stdexcept>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// mergearray for k sorted inputs at once. the inputs are sources, anything
+// with a value_type and a `bool next(value_type &)` that yields values in
+// order and returns false at the end, and the output goes to a sink called
+// once per value, so memory is what the sources buffer, whatever they hold
+
+// a tournament over k inputs that keeps only the losers: each internal node
+// holds the input that lost the match there, and the overall winner sits
+// apart. when the winner's input moves to its next value, that value replays
+// the matches on its own path to the root, log2(k) comparisons against
+// nodes that are never rebuilt. ties go to the lower input, so merging is
+// stable, and an exhausted input loses every match
+template <typename T, typename Compare = std::less<T>>
+class LoserTree {
+    std::vector<T> heads;               // each input's current value
+    std::vector<char> live;
+    std::vector<std::size_t> losers;    // losers[0] is the winner; leaf i is node k + i
+    std::size_t k;
+    std::size_t remaining;
+    Compare comp;
+
+    bool beats(std::size_t a, std::size_t b) const;
+    std::size_t build(std::size_t node);
+    void replay(std::size_t input);
+
+    public:
+    explicit LoserTree(std::size_t inputs, Compare comp = Compare()) : heads(inputs), live(inputs, 0), losers(inputs ? inputs : 1), k(inputs), remaining(0), comp(comp) {}
+
+    // before start(): input i begins with value, or is empty if never set
+    void set(std::size_t input, const T & value) {
+        heads[input] = value;
+        live[input] = 1;
+    }
+    void start();
+
+    bool empty() const { return remaining == 0; }
+    std::size_t top() const { return losers[0]; }
+    const T & min() const { return heads[losers[0]]; }
+    // the winner's input moves on to value, or has run out
+    void replace(const T & value);
+    void close();
+};
+
+template <typename T, typename Compare>
+bool LoserTree<T, Compare>::beats(std::size_t a, std::size_t b) const {
+    if (!live[a] || !live[b]) return live[a] || (!live[b] && a < b);
+    if (comp(heads[a], heads[b])) return true;
+    if (comp(heads[b], heads[a])) return false;
+    return a < b;
+}
+
+template <typename T, typename Compare>
+std::size_t LoserTree<T, Compare>::build(std::size_t node) {
+    if (node >= k) return node - k;
+    auto left = build(2 * node), right = build(2 * node + 1);
+    if (beats(left, right)) {
+        losers[node] = right;
+        return left;
+    }
+    losers[node] = left;
+    return right;
+}
+
+template <typename T, typename Compare>
+void LoserTree<T, Compare>::start() {
+    remaining = 0;
+    for (auto i : live) remaining += (i != 0);
+    if (k) losers[0] = build(1);
+}
+
+template <typename T, typename Compare>
+void LoserTree<T, Compare>::replay(std::size_t input) {
+    auto winner = input;
+    for (auto node = (k + input) / 2; node > 0; node /= 2) {
+        if (beats(losers[node], winner)) std::swap(losers[node], winner);
+    }
+    losers[0] = winner;
+}
+
+template <typename T, typename Compare>
+void LoserTree<T, Compare>::replace(const T & value) {
+    heads[losers[0]] = value;
+    replay(losers[0]);
+}
+
+template <typename T, typename Compare>
+void LoserTree<T, Compare>::close() {
+    live[losers[0]] = 0;
+    --remaining;
+    replay(losers[0]);
+}
+
+// merges the sources into sink. an input that goes backwards would silently
+// break the order of the output, so it is reported instead. a sink returning
+// bool stops the merge by returning false
+template <typename Source, typename Sink, typename Compare = std::less<typename Source::value_type>>
+void kway_merge(std::vector<Source> & sources, Sink && sink, Compare comp = Compare()) {
+    using T = typename Source::value_type;
+    LoserTree<T, Compare> tree(sources.size(), comp);
+    T value;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i].next(value)) tree.set(i, value);
+    }
+    tree.start();
+    while (!tree.empty()) {
+        if constexpr (std::is_same<decltype(sink(tree.min())), bool>::value) {
+            if (!sink(tree.min())) return;
+        }
+        else sink(tree.min());
+        auto input = tree.top();
+        if (!sources[input].next(value)) tree.close();
+        else if (comp(value, tree.min())) throw std::runtime_error("kway_merge: input " + std::to_string(input) + " is not sorted");
+        else tree.replace(value);
+    }
+}
+
+// merges the sources and folds each run of equal values into one,
+// reduce(so_far, next), before it reaches sink: counts or sums per key when
+// Compare looks only at the key
+template <typename Source, typename Sink, typename Reduce, typename Compare = std::less<typename Source::value_type>>
+void kway_merge_reduce(std::vector<Source> & sources, Sink && sink, Reduce reduce, Compare comp = Compare()) {
+    using T = typename Source::value_type;
+    T pending;
+    bool held = false;
+    kway_merge(sources, [&](const T & value) {
+        // the output is sorted, so anything not after pending is equal to it
+        if (held && !comp(pending, value)) pending = reduce(pending, value);
+        else {
+            if (held) sink(pending);
+            pending = value;
+            held = true;
+        }
+    }, comp);
+    if (held) sink(pending);
+}
+
+// merges the sources, keeping the first of each run of equal values
+template <typename Source, typename Sink, typename Compare = std::less<typename Source::value_type>>
+void kway_merge_unique(std::vector<Source> & sources, Sink && sink, Compare comp = Compare()) {
+    using T = typename Source::value_type;
+    kway_merge_reduce(sources, sink, [](const T & first, const T &) { return first; }, comp);
+}
+
+// a sorted vector as a source
+template <typename T>
+class VectorSource {
+    const std::vector<T> * vec;
+    std::size_t position;
+
+    public:
+    using value_type = T;
+    explicit VectorSource(const std::vector<T> & vec) : vec(&vec), position(0) {}
+    bool next(T & value) {
+        if (position == vec->size()) return false;
+        value = (*vec)[position++];
+        return true;
+    }
+};
+
+// the in-memory form: the sorted runs merged into one vector
+template <typename T>
+std::vector<T> kway_merge(const std::vector<std::vector<T>> & runs) {
+    std::vector<VectorSource<T>> sources;
+    std::size_t total = 0;
+    for (auto && run : runs) {
+        sources.emplace_back(run);
+        total += run.size();
+    }
+    std::vector<T> merged;
+    merged.reserve(total);
+    kway_merge(sources, [&](const T & value) { merged.push_back(value); });
+    return merged;
+}
+
+// whitespace-separated integers from a file, read through a fixed buffer,
+// so a file of any size costs `capacity` bytes
+class NumberReader {
+    int fd;
+    std::string path;
+    std::vector<char> buffer;
+    std::size_t position;
+    std::size_t end;
+    bool finished;
+
+    int peek();
+
+    public:
+    using value_type = long long;
+    explicit NumberReader(const std::string & path, std::size_t capacity = 1 << 16);
+    NumberReader(NumberReader && rhs) noexcept : fd(rhs.fd), path(std::move(rhs.path)), buffer(std::move(rhs.buffer)), position(rhs.position), end(rhs.end), finished(rhs.finished) { rhs.fd = -1; }
+    NumberReader(const NumberReader &) = delete;
+    NumberReader & operator=(const NumberReader &) = delete;
+    ~NumberReader() { if (fd >= 0) ::close(fd); }
+
+    bool next(long long & value);
+};
+
+inline NumberReader::NumberReader(const std::string & path, std::size_t capacity) : fd(-1), path(path), buffer(capacity ? capacity : 1), position(0), end(0), finished(false) {
+    fd = (path == "-") ? ::dup(STDIN_FILENO) : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+// the next character, refilling the buffer as needed, or -1 at the end
+inline int NumberReader::peek() {
+    if (position == end) {
+        if (finished) return -1;
+        ssize_t count;
+        do count = ::read(fd, buffer.data(), buffer.size());
+        while (count < 0 && errno == EINTR);
+        if (count < 0) throw std::runtime_error("cannot read " + path);
+        position = 0;
+        end = std::size_t(count);
+        finished = (end == 0);
+        if (finished) return -1;
+    }
+    return static_cast<unsigned char>(buffer[position]);
+}
+
+inline bool NumberReader::next(long long & value) {
+    auto c = peek();
+    while (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+        ++position;
+        c = peek();
+    }
+    if (c < 0) return false;
+    bool negative = (c == '-');
+    if (negative) {
+        ++position;
+        c = peek();
+    }
+    if (c < '0' || c > '9') throw std::runtime_error(path + ": not a number");
+    unsigned long long magnitude = 0;
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + unsigned(c - '0');
+        ++position;
+        c = peek();
+    }
+    value = negative ? -(long long)magnitude : (long long)magnitude;
+    return true;
+}
+
+#endif
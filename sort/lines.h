@@ -0,0 +1,85 @@
+#ifndef LINES_H
+#define LINES_H
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// newline-delimited text as string_views into a single buffer: a file is
+// mapped and never copied, a stream is read into memory once. the views stay
+// valid for the lifetime of the Lines object
+class Lines {
+    const char * data;
+    std::size_t length;
+    bool mapped;
+    std::string buffer;
+    std::vector<std::string_view> lines;
+
+    void split();
+
+    public:
+    explicit Lines(const std::string & path);
+    explicit Lines(std::istream & in);
+    ~Lines();
+    Lines(const Lines &) = delete;
+    Lines & operator=(const Lines &) = delete;
+
+    std::vector<std::string_view> & views() { return lines; }
+    std::size_t bytes() const { return length; }
+};
+
+inline Lines::Lines(const std::string & path) : data(nullptr), length(0), mapped(false) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    length = std::size_t(st.st_size);
+    if (length) {
+        auto address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path);
+        }
+        // the lines are read front to back once, to split them
+        ::madvise(address, length, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(address);
+        mapped = true;
+    }
+    ::close(fd);
+    split();
+}
+
+inline Lines::Lines(std::istream & in) : data(nullptr), length(0), mapped(false) {
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    length = buffer.size();
+    split();
+}
+
+inline Lines::~Lines() {
+    if (mapped) ::munmap(const_cast<char *>(data), length);
+}
+
+inline void Lines::split() {
+    auto start = data, end = data + length;
+    while (start < end) {
+        auto newline = static_cast<const char *>(std::memchr(start, '\n', std::size_t(end - start)));
+        // a last line without its newline
+        if (!newline) newline = end;
+        lines.emplace_back(start, std::size_t(newline - start));
+        start = newline + 1;
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef MERGESORT_H
+#define MERGESORT_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+template <typename T>
+void mergearray(std::vector<T> & vec, int first, int mid, int last, std::vector<T> & temp) {
+    auto i = first, m = mid;
+    auto j = mid + 1, n = last;
+    auto k = 0;
+
+    while (i <= m && j <= n) {
+        // copy whichever is smaller from the two arrays to the temporary array
+        if (vec[i] <= vec[j]) {
+            temp[k++] = vec[i++];
+        }
+        else {
+            temp[k++] = vec[j++];
+        }
+    }
+
+    // copy the rest of the two arrays to the temporary array
+    // only one of them could possibly still have elements left
+    while (i <= m) temp[k++] = vec[i++];
+    while (j <= n) temp[k++] = vec[j++];
+
+    // need to change the `vec` vector as well, as the recursion in mergesort() is done in sequence
+    for (i = 0; i < k; ++i) {
+        vec[first + i] = temp[i];
+    }
+}
+
+template <typename T>
+void mergesort(std::vector<T> & vec, int first, int last, std::vector<T> & temp) {
+    if (first < last) {
+        auto mid = (first + last) / 2;
+        mergesort(vec, first, mid, temp);
+        mergesort(vec, mid + 1, last, temp);
+        mergearray(vec, first, mid, last, temp);
+    }
+}
+
+// bottom-up over the runs already in the input: strictly descending runs are
+// reversed in place, then neighbouring runs are merged pairwise, so sorted
+// input costs one pass and k runs cost log2(k) passes
+template <typename T>
+void naturalmergesort(std::vector<T> & vec, std::vector<T> & temp) {
+    int n = int(vec.size());
+    std::vector<int> bounds{ 0 };  // run i is [bounds[i], bounds[i + 1])
+    for (int i = 0; i < n; ) {
+        auto j = i + 1;
+        if (j < n && vec[j] < vec[i]) {
+            while (j < n && vec[j] < vec[j - 1]) ++j;
+            std::reverse(vec.begin() + i, vec.begin() + j);
+        }
+        else {
+            while (j < n && vec[j] >= vec[j - 1]) ++j;
+        }
+        bounds.push_back(j);
+        i = j;
+    }
+    while (bounds.size() > 2) {
+        std::vector<int> merged{ 0 };
+        std::size_t r = 0;
+        for (; r + 2 < bounds.size(); r += 2) {
+            mergearray(vec, bounds[r], bounds[r + 1] - 1, bounds[r + 2] - 1, temp);
+            merged.push_back(bounds[r + 2]);
+        }
+        // an odd run out waits for the next pass
+        if (r + 1 < bounds.size()) merged.push_back(bounds.back());
+        bounds.swap(merged);
+    }
+}
+
+#endif
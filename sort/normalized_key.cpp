@@ -0,0 +1,39 @@
+// sorts rows of "tenant timestamp id" by tenant, newest first within a
+// tenant, then by id; a timestamp of "-" is null and sorts last
+#include <iostream>
+#include <vector>
+#include <string>
+#include <optional>
+
+#include "normalized_key.h"
+
+struct Event {
+    std::string tenant;
+    std::optional<long long> timestamp;
+    long long id;
+};
+
+int main() {
+    std::cout << "Input tenant timestamp id rows here: " << std::endl;
+    std::vector<Event> events;
+    std::string tenant, timestamp;
+    long long id;
+    while (std::cin >> tenant >> timestamp >> id) {
+        std::optional<long long> time;
+        if (timestamp != "-") time = std::stoll(timestamp);
+        events.push_back({ tenant, time, id });
+    }
+
+    SortKey<Event> key;
+    key.column([](const Event & e) { return std::string_view(e.tenant); })
+       .column([](const Event & e) { return e.timestamp; }, Order::descending, Nulls::last)
+       .column([](const Event & e) { return e.id; });
+    sort_normalized(events, key);
+
+    for (auto && e : events) {
+        std::cout << e.tenant << " ";
+        if (e.timestamp) std::cout << *e.timestamp;
+        else std::cout << "-";
+        std::cout << " " << e.id << std::endl;
+    }
+}
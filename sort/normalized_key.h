@@ -0,0 +1,184 @@
+#ifndef NORMALIZED_KEY_H
+#define NORMALIZED_KEY_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#include "argsort.h"
+#include "stringsort.h"
+
+// multi-column sorting by normalized keys: each row's sort columns are encoded
+// once into a byte string that compares, byte by byte as unsigned chars, the
+// way the rows should sort. the kernels then compare bytes and know nothing of
+// columns, directions or nulls, instead of a comparator branching on each
+// field at every one of the n log n comparisons
+//
+// every column's encoding is prefix-free, so the first byte where two keys
+// differ lies inside the first column where the rows differ:
+//   - a nullable column starts with a marker, 0 for null and 1 for a value
+//     (2 for null when nulls go last); a null has nothing after its marker
+//   - integers are big-endian with the sign bit flipped, so negatives order first
+//   - floating-point numbers have every bit flipped when negative and only the
+//     sign bit otherwise; -0 is encoded as 0 and every NaN as one NaN, after +inf
+//   - strings have each 0 byte escaped as 0 255 and end in 0 0, so a string
+//     sorts before any longer one it is a prefix of
+//   - a descending column has its bytes, but not its null marker, inverted,
+//     so nulls go first or last whichever the direction
+enum class Order { ascending, descending };
+enum class Nulls { first, last };
+
+template <typename T>
+struct is_optional : std::false_type {};
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value>::type encode_value(T value, std::string & out) {
+    using U = typename std::make_unsigned<T>::type;
+    auto bits = U(value);
+    if (std::is_signed<T>::value) bits ^= U(U(1) << (sizeof(T) * 8 - 1));
+    for (auto shift = int(sizeof(T) * 8) - 8; shift >= 0; shift -= 8) out.push_back(char((bits >> shift) & 0xff));
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type encode_value(T value, std::string & out) {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "only float and double have an encoding");
+    using U = typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type;
+    if (value == 0) value = 0;
+    if (std::isnan(value)) value = std::numeric_limits<T>::quiet_NaN();
+    U bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const U sign = U(1) << (sizeof(T) * 8 - 1);
+    bits = (bits & sign) ? U(~bits) : U(bits ^ sign);
+    encode_value(bits, out);
+}
+
+inline void encode_value(std::string_view value, std::string & out) {
+    for (auto c : value) {
+        out.push_back(c);
+        if (c == 0) out.push_back(char(0xff));
+    }
+    out.push_back(0);
+    out.push_back(0);
+}
+
+// which columns rows sort by, in order of significance. each column is a
+// function of the row returning an integer, a float or double, a string or
+// string_view, or a std::optional of one of those for a column with nulls:
+//   SortKey<Event> key;
+//   key.column([](const Event & e) { return e.tenant; })
+//      .column([](const Event & e) { return e.timestamp; }, Order::descending)
+//      .column([](const Event & e) { return e.id; });
+// columns are called through std::function, once per row, while encoding
+template <typename Record>
+class SortKey {
+    std::vector<std::function<void(const Record &, std::string &)>> columns;
+
+    template <typename T>
+    static void encode_column(const T & value, Order order, Nulls nulls, std::string & out);
+
+    public:
+    template <typename Column>
+    SortKey & column(Column column, Order order = Order::ascending, Nulls nulls = Nulls::first);
+
+    std::size_t size() const { return columns.size(); }
+    // appends the normalized key of record to out
+    void encode(const Record & record, std::string & out) const {
+        for (auto && column : columns) column(record, out);
+    }
+    std::string operator()(const Record & record) const {
+        std::string out;
+        encode(record, out);
+        return out;
+    }
+};
+
+template <typename Record>
+template <typename T>
+void SortKey<Record>::encode_column(const T & value, Order order, Nulls nulls, std::string & out) {
+    if constexpr (is_optional<T>::value) {
+        if (!value) {
+            out.push_back(char((nulls == Nulls::first) ? 0 : 2));
+            return;
+        }
+        out.push_back(1);
+        encode_column(*value, order, nulls, out);
+    }
+    else {
+        auto start = out.size();
+        if constexpr (std::is_arithmetic<T>::value) encode_value(value, out);
+        else encode_value(std::string_view(value), out);
+        if (order == Order::descending) {
+            for (auto i = start; i < out.size(); ++i) out[i] = char(~out[i]);
+        }
+    }
+}
+
+template <typename Record>
+template <typename Column>
+SortKey<Record> & SortKey<Record>::column(Column column, Order order, Nulls nulls) {
+    columns.push_back([column, order, nulls](const Record & record, std::string & out) {
+        encode_column(column(record), order, nulls, out);
+    });
+    return *this;
+}
+
+enum class NormalizedKernels { radix, quick };
+
+// the permutation that sorts records by key, stable: perm[i] is the index of
+// the record that belongs at position i. the keys are encoded into one arena,
+// each followed by its row's index big-endian, so the kernels see distinct
+// byte strings whose order breaks ties by position, and the index is read
+// back from the tail of each sorted key. `kernel` picks msd_radixsort or
+// multikey_quicksort from stringsort.h; both skip the bytes a range shares
+template <typename Record>
+std::vector<std::size_t> argsort_normalized(const std::vector<Record> & records, const SortKey<Record> & key,
+                                            NormalizedKernels kernel = NormalizedKernels::radix) {
+    auto n = records.size();
+    if (n == 0) return {};
+    std::size_t index_bytes = 1;
+    while (index_bytes < 8 && (n - 1) >> (8 * index_bytes)) ++index_bytes;
+
+    std::string arena;
+    std::vector<std::size_t> ends(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        key.encode(records[i], arena);
+        for (auto b = index_bytes; b-- > 0; ) arena.push_back(char((i >> (8 * b)) & 0xff));
+        ends[i] = arena.size();
+    }
+    // views are taken only once the arena has stopped growing
+    std::vector<std::string_view> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto begin = i ? ends[i - 1] : 0;
+        keys[i] = std::string_view(arena.data() + begin, ends[i] - begin);
+    }
+
+    if (kernel == NormalizedKernels::quick) multikey_quicksort(keys);
+    else msd_radixsort(keys);
+
+    std::vector<std::size_t> perm(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t index = 0;
+        auto tail = keys[i].data() + keys[i].size() - index_bytes;
+        for (std::size_t b = 0; b < index_bytes; ++b) index = (index << 8) | std::uint8_t(tail[b]);
+        perm[i] = index;
+    }
+    return perm;
+}
+
+// sorts the records themselves, each swapped into place once
+template <typename Record>
+void sort_normalized(std::vector<Record> & records, const SortKey<Record> & key,
+                     NormalizedKernels kernel = NormalizedKernels::radix) {
+    apply_permutation(records, argsort_normalized(records, key, kernel));
+}
+
+#endif
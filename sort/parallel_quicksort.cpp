@@ -0,0 +1,14 @@
+#include <iostream>
+#include <vector>
+
+#include "parallel_quicksort.h"
+
+int main() {
+    int num;
+    std::vector<int> vec;
+    while (std::cin >> num) {
+        vec.push_back(num);
+    }
+    parallel_quicksort(vec, 0, vec.size() - 1);
+    for (auto && i : vec) { std::cout << i << " "; }
+}
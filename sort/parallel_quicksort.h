@@ -0,0 +1,281 @@
+#ifndef PARALLEL_QUICKSORT_H
+#define PARALLEL_QUICKSORT_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+
+#include "insertionsort.h"
+#include "quicksort.h"
+#include "select.h"
+
+// quicksort on every core without giving up sorting in place. the first
+// levels, whose ranges are too large for one thread, are partitioned by all
+// threads together; the ranges that come out of them go to a work-stealing
+// pool, where each worker splits its range further until it is under the
+// grain size and sorts that alone. beyond the vector itself it needs O(p)
+// for the partitions and O(log n) per worker for stacks and queues
+
+// twice the depth of a balanced recursion; a range that needs more splits
+// than this has had bad pivots
+inline int depth_budget(int n) {
+    int depth = 0;
+    while (n > 1) {
+        n >>= 1;
+        ++depth;
+    }
+    return 2 * depth;
+}
+
+template <typename Work>
+void run_threads(unsigned threads, Work work) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) workers.emplace_back(work, t);
+    for (auto && worker : workers) worker.join();
+}
+
+// vec[low] is the pivot and nothing after it is smaller: gathers the elements
+// equal to it at the front, where they are in their final place, and returns
+// the last of them. without this a run of equal keys shrinks by one per split
+template <typename T>
+int skip_equal(std::vector<T> & vec, int low, int high) {
+    auto key = vec[low];
+    auto i = low + 1, j = high;
+    while (true) {
+        while (i <= j && !(key < vec[i])) ++i;
+        while (i <= j && key < vec[j]) --j;
+        if (i >= j) break;
+        std::swap(vec[i++], vec[j--]);
+    }
+    return i - 1;
+}
+
+// one quicksort step on vec[low..high] with a median-of-three pivot: returns
+// the last index of the left part and the first of the right one
+template <typename T>
+std::pair<int, int> split(std::vector<T> & vec, int low, int high) {
+    auto mid = low + (high - low) / 2;
+    if (vec[mid] < vec[low]) std::swap(vec[mid], vec[low]);
+    if (vec[high] < vec[mid]) std::swap(vec[high], vec[mid]);
+    if (vec[mid] < vec[low]) std::swap(vec[mid], vec[low]);
+    std::swap(vec[low], vec[mid]);
+    auto first = partition(vec, low, high);
+    if (first == low) return std::make_pair(low - 1, skip_equal(vec, low, high) + 1);
+    return std::make_pair(first - 1, first + 1);
+}
+
+// the single-threaded kernel the workers end on: recursion only into the
+// smaller part, so the stack is O(log n), and once `budget` splits are used
+// up the pivot is the exact median, which keeps the worst case O(n log n)
+template <typename T>
+void bounded_quicksort(std::vector<T> & vec, int low, int high, int budget) {
+    while (high - low + 1 > 16) {
+        std::pair<int, int> parts;
+        if (budget-- <= 0) {
+            auto mid = low + (high - low) / 2;
+            nth_element(vec, low, high, mid);
+            parts = std::make_pair(mid - 1, mid + 1);
+        }
+        else parts = split(vec, low, high);
+
+        if (parts.first - low < high - parts.second) {
+            bounded_quicksort(vec, low, parts.first, budget);
+            low = parts.second;
+        }
+        else {
+            bounded_quicksort(vec, parts.second, high, budget);
+            high = parts.first;
+        }
+    }
+    insertionsort(vec, low, high);
+}
+
+template <typename T>
+void bounded_quicksort(std::vector<T> & vec, int low, int high) {
+    bounded_quicksort(vec, low, high, depth_budget(high - low + 1));
+}
+
+// partitions vec[low..high] by pred with `threads` threads and returns the
+// first index whose element fails it. each thread partitions one block of
+// the range on its own; after that the elements failing pred that lie left
+// of the split and the ones passing it that lie right of it are equal in
+// number, and the threads swap them pairwise, each a share of the pairs
+template <typename T, typename Predicate>
+int parallel_partition(std::vector<T> & vec, int low, int high, Predicate pred, unsigned threads) {
+    auto n = std::int64_t(high - low + 1);
+    auto block = [&](unsigned t) { return std::make_pair(low + int(n * t / threads), low + int(n * (t + 1) / threads)); };
+    std::vector<int> splits(threads);
+    run_threads(threads, [&](unsigned t) {
+        auto range = block(t);
+        auto i = range.first, j = range.second - 1;
+        while (true) {
+            while (i <= j && pred(vec[i])) ++i;
+            while (i <= j && !pred(vec[j])) --j;
+            if (i >= j) break;
+            std::swap(vec[i++], vec[j--]);
+        }
+        splits[t] = i;
+    });
+    auto mid = low;
+    for (unsigned t = 0; t < threads; ++t) mid += splits[t] - block(t).first;
+
+    // the misplaced elements as half-open intervals, in index order
+    std::vector<std::pair<int, int>> failing, passing;
+    std::int64_t misplaced = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        auto range = block(t);
+        auto end = (range.second < mid) ? range.second : mid;
+        if (splits[t] < end) {
+            failing.emplace_back(splits[t], end);
+            misplaced += end - splits[t];
+        }
+        auto begin = (range.first > mid) ? range.first : mid;
+        if (begin < splits[t]) passing.emplace_back(begin, splits[t]);
+    }
+    if (misplaced == 0) return mid;
+
+    // the k-th misplaced element of a list: which interval, and its index
+    auto locate = [](const std::vector<std::pair<int, int>> & intervals, std::int64_t k) {
+        std::size_t which = 0;
+        while (k >= intervals[which].second - intervals[which].first) {
+            k -= intervals[which].second - intervals[which].first;
+            ++which;
+        }
+        return std::make_pair(which, intervals[which].first + int(k));
+    };
+    auto helpers = unsigned((misplaced / 4096 + 1 < std::int64_t(threads)) ? misplaced / 4096 + 1 : threads);
+    run_threads(helpers, [&](unsigned t) {
+        auto first = misplaced * t / helpers, last = misplaced * (t + 1) / helpers;
+        if (first == last) return;
+        auto a = locate(failing, first), b = locate(passing, first);
+        for (auto k = first; k < last; ++k) {
+            std::swap(vec[a.second], vec[b.second]);
+            if (++a.second == failing[a.first].second && ++a.first < failing.size()) a.second = failing[a.first].first;
+            if (++b.second == passing[b.first].second && ++b.first < passing.size()) b.second = passing[b.first].first;
+        }
+    });
+    return mid;
+}
+
+// a range still to sort, and how many more splits it may take before its
+// pivots count as bad
+struct QuicksortRange {
+    int low;
+    int high;
+    int budget;
+};
+
+// a worker's ranges: the owner pushes and pops at the back, so it works
+// depth first on the smallest, most recent ranges, and thieves take from the
+// front, where the oldest and largest are
+class StealingQueue {
+    std::mutex lock;
+    std::deque<QuicksortRange> ranges;
+
+    public:
+    void push(const QuicksortRange & range) {
+        std::lock_guard<std::mutex> guard(lock);
+        ranges.push_back(range);
+    }
+    bool pop(QuicksortRange & range) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (ranges.empty()) return false;
+        range = ranges.back();
+        ranges.pop_back();
+        return true;
+    }
+    bool steal(QuicksortRange & range) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (ranges.empty()) return false;
+        range = ranges.front();
+        ranges.pop_front();
+        return true;
+    }
+};
+
+// sorts vec[low..high] in place on `threads` threads. ranges of at most
+// `grain` elements are sorted by one thread without being split further
+template <typename T>
+void parallel_quicksort(std::vector<T> & vec, int low, int high, unsigned threads = std::thread::hardware_concurrency(), int grain = 16384) {
+    auto n = high - low + 1;
+    if (threads == 0) threads = 1;
+    if (grain < 16) grain = 16;
+    if (threads == 1 || n <= grain) {
+        bounded_quicksort(vec, low, high);
+        return;
+    }
+
+    // ranges above this get all threads: no worker could take them alone
+    // without the others waiting
+    auto shared = (n / int(threads) > 65536) ? n / int(threads) : 65536;
+    std::vector<QuicksortRange> ranges = { { low, high, depth_budget(n) } }, tasks;
+    while (!ranges.empty()) {
+        auto range = ranges.back();
+        ranges.pop_back();
+        if (range.high - range.low + 1 <= shared || range.budget == 0) {
+            tasks.push_back(range);
+            continue;
+        }
+        // the pivot is the median of three medians of three
+        auto step = (range.high - range.low) / 8;
+        auto median = [&](int a, int b, int c) {
+            if (vec[b] < vec[a]) std::swap(a, b);
+            if (vec[c] < vec[b]) std::swap(b, c);
+            if (vec[b] < vec[a]) std::swap(a, b);
+            return b;
+        };
+        auto middle = range.low + (range.high - range.low) / 2;
+        auto pivot = median(median(range.low, range.low + step, range.low + 2 * step),
+                            median(middle - step, middle, middle + step),
+                            median(range.high - 2 * step, range.high - step, range.high));
+        auto key = vec[pivot];
+
+        auto mid = parallel_partition(vec, range.low, range.high, [&](const T & x) { return x < key; }, threads);
+        auto left = QuicksortRange{ range.low, mid - 1, range.budget - 1 };
+        if (mid == range.low) {
+            // nothing was smaller than the pivot: the ones equal to it are done
+            mid = parallel_partition(vec, range.low, range.high, [&](const T & x) { return !(key < x); }, threads);
+            left.high = range.low - 1;
+        }
+        auto right = QuicksortRange{ mid, range.high, range.budget - 1 };
+        if (left.high > left.low) ranges.push_back(left);
+        if (right.high > right.low) ranges.push_back(right);
+    }
+
+    std::vector<StealingQueue> queues(threads);
+    std::atomic<std::size_t> pending(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) queues[i % threads].push(tasks[i]);
+    run_threads(threads, [&](unsigned t) {
+        QuicksortRange range;
+        while (pending.load() > 0) {
+            auto found = queues[t].pop(range);
+            for (unsigned k = 1; k < threads && !found; ++k) found = queues[(t + k) % threads].steal(range);
+            if (!found) {
+                std::this_thread::yield();
+                continue;
+            }
+            // the larger part is left for later or for a thief, and the
+            // smaller one split next, so a queue holds O(log n) ranges
+            while (range.high - range.low + 1 > grain && range.budget > 0) {
+                auto parts = split(vec, range.low, range.high);
+                auto left = QuicksortRange{ range.low, parts.first, range.budget - 1 };
+                auto right = QuicksortRange{ parts.second, range.high, range.budget - 1 };
+                if (left.high - left.low > right.high - right.low) std::swap(left, right);
+                if (right.high > right.low) {
+                    // counted before it can be seen, so pending never reads 0 early
+                    ++pending;
+                    queues[t].push(right);
+                }
+                range = left;
+            }
+            bounded_quicksort(vec, range.low, range.high, range.budget);
+            --pending;
+        }
+    });
+}
+
+#endif
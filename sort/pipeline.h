@@ -0,0 +1,316 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sort.h"
+#include "kway_merge.h"
+
+// a queue between two pipeline stages. push() waits while it is full, so a
+// fast producer cannot run ahead of memory, and returns false, dropping the
+// item, once it is closed, so the producer can stop. pop() waits while it is
+// empty, returning false once it is closed and drained
+template <typename T>
+class Channel {
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::size_t capacity;
+    bool closed;
+
+    public:
+    explicit Channel(std::size_t capacity) : capacity(capacity ? capacity : 1), closed(false) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return items.size() < capacity || closed; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+    bool pop(T & item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+    // wakes every waiter; what is queued can still be popped
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+};
+
+inline void read_fully(int fd, char * data, std::size_t size, std::size_t & got) {
+    got = 0;
+    while (got < size) {
+        auto count = ::read(fd, data + got, size - got);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) throw std::runtime_error("read failed");
+        if (count == 0) return;
+        got += std::size_t(count);
+    }
+}
+
+inline void write_fully(int fd, const char * data, std::size_t size) {
+    while (size) {
+        auto count = ::write(fd, data, size);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) throw std::runtime_error("write failed");
+        data += count;
+        size -= std::size_t(count);
+    }
+}
+
+// appends the whitespace-separated integers of [first, last) to values
+inline void parse_numbers(const char * first, const char * last, std::vector<long long> & values) {
+    while (true) {
+        while (first != last && (*first == ' ' || *first == '\n' || *first == '\t' || *first == '\r')) ++first;
+        if (first == last) return;
+        long long value;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc() || (result.ptr != last && *result.ptr != ' ' && *result.ptr != '\n' && *result.ptr != '\t' && *result.ptr != '\r')) {
+            throw std::runtime_error("not a number: " + std::string(first, std::min<std::size_t>(std::size_t(last - first), 20)));
+        }
+        values.push_back(value);
+        first = result.ptr;
+    }
+}
+
+// a sorted run for kway_merge, held in memory or spilled to a temporary file
+// that is unlinked as soon as it is made, so nothing is left behind on exit
+class Run {
+    std::vector<long long> values;
+    int fd;
+    std::size_t position;
+    std::size_t end;
+
+    public:
+    using value_type = long long;
+    explicit Run(std::vector<long long> && sorted) : values(std::move(sorted)), fd(-1), position(0), end(values.size()) {}
+    Run(std::vector<long long> && sorted, const std::string & directory);
+    Run(Run && rhs) noexcept : values(std::move(rhs.values)), fd(rhs.fd), position(rhs.position), end(rhs.end) { rhs.fd = -1; }
+    Run(const Run &) = delete;
+    Run & operator=(const Run &) = delete;
+    ~Run() { if (fd >= 0) ::close(fd); }
+
+    bool spilled() const { return fd >= 0; }
+    bool next(long long & value);
+};
+
+inline Run::Run(std::vector<long long> && sorted, const std::string & directory) : fd(-1), position(0), end(0) {
+    std::string path = directory + "/psort.XXXXXX";
+    fd = ::mkstemp(&path[0]);
+    if (fd < 0) throw std::runtime_error("cannot create a run file in " + directory);
+    ::unlink(path.c_str());
+    write_fully(fd, reinterpret_cast<const char *>(sorted.data()), sorted.size() * sizeof(long long));
+    if (::lseek(fd, 0, SEEK_SET) != 0) throw std::runtime_error("cannot rewind a run file");
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    // the vector becomes the read buffer, 1 MiB of it
+    sorted.clear();
+    sorted.resize((1 << 20) / sizeof(long long));
+    sorted.shrink_to_fit();
+    values = std::move(sorted);
+}
+
+inline bool Run::next(long long & value) {
+    if (position == end) {
+        if (fd < 0) return false;
+        std::size_t got;
+        read_fully(fd, reinterpret_cast<char *>(values.data()), values.size() * sizeof(long long), got);
+        position = 0;
+        end = got / sizeof(long long);
+        if (end == 0) return false;
+    }
+    value = values[position++];
+    return true;
+}
+
+struct PipelineOptions {
+    unsigned threads = std::thread::hardware_concurrency();
+    std::size_t chunk_bytes = std::size_t(64) << 20;    // text read and sorted as one run
+    std::size_t memory_bytes = std::size_t(2) << 30;   // sorted runs kept in memory before spilling
+    std::string temp_directory = "/tmp";
+};
+
+// milliseconds from the start at which each stage finished
+struct PipelineStats {
+    std::size_t bytes = 0;
+    std::size_t numbers = 0;
+    std::size_t runs = 0;
+    std::size_t spilled = 0;
+    double read_ms = 0;
+    double sort_ms = 0;
+    double total_ms = 0;
+};
+
+// sorts the integers of in_fd to out_fd, one per line, with the stages
+// overlapping instead of taking turns:
+//
+//   read   one thread reads chunk_bytes at a time, cut after the last
+//          whitespace, and queues it
+//   sort   a pool parses each chunk and sorts it with sort(), as it arrives,
+//          into a run; runs beyond memory_bytes go to temporary files
+//   merge  once the last run is sorted, the runs are merged by kway_merge
+//          and formatted into buffers
+//   write  one thread writes the buffers while the merge fills the next
+//
+// reading and sorting go on together, and so do merging and writing, so the
+// wall time is about the larger of the I/O and the sorting, not their sum.
+// the merge cannot start before the last chunk is sorted, since the last
+// chunk may hold the smallest number
+inline PipelineStats pipelined_sort(int in_fd, int out_fd, const PipelineOptions & options) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    auto since = [&] { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+    PipelineStats stats;
+    auto threads = options.threads ? options.threads : 1;
+
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    auto fail = [&] {
+        std::lock_guard<std::mutex> lock(failure_mutex);
+        if (!failure) failure = std::current_exception();
+    };
+
+    // a chunk waits for a worker, at most one per worker and one in hand
+    Channel<std::string> chunks(threads);
+    std::mutex runs_mutex;
+    std::vector<Run> runs;
+    std::size_t resident = 0;
+
+    std::thread reader([&] {
+        try {
+            std::string carry;
+            while (true) {
+                std::string chunk = std::move(carry);
+                carry.clear();
+                auto kept = chunk.size();
+                chunk.resize(kept + options.chunk_bytes);
+                std::size_t got;
+                read_fully(in_fd, &chunk[kept], options.chunk_bytes, got);
+                chunk.resize(kept + got);
+                stats.bytes += got;
+                if (got == 0) {
+                    if (!chunk.empty()) chunks.push(std::move(chunk));
+                    break;
+                }
+                // a number cut by the end of the chunk goes on to the next one
+                auto cut = chunk.find_last_of(" \n\t\r");
+                if (cut == std::string::npos) {
+                    carry = std::move(chunk);
+                    continue;
+                }
+                carry.assign(chunk, cut + 1, std::string::npos);
+                chunk.resize(cut + 1);
+                // closed by a worker that failed: the rest of the input is not wanted
+                if (!chunks.push(std::move(chunk))) break;
+            }
+        }
+        catch (...) {
+            fail();
+        }
+        chunks.close();
+        stats.read_ms = since();
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            std::string chunk;
+            while (chunks.pop(chunk)) {
+                try {
+                    std::vector<long long> values;
+                    values.reserve(chunk.size() / 8);
+                    parse_numbers(chunk.data(), chunk.data() + chunk.size(), values);
+                    std::string().swap(chunk);
+                    if (values.empty()) continue;
+                    sort(values);
+                    auto bytes = values.size() * sizeof(long long);
+                    bool spill;
+                    {
+                        std::lock_guard<std::mutex> lock(runs_mutex);
+                        spill = resident + bytes > options.memory_bytes;
+                        if (!spill) resident += bytes;
+                    }
+                    // the file is written outside the lock, the other workers go on
+                    Run run = spill ? Run(std::move(values), options.temp_directory) : Run(std::move(values));
+                    std::lock_guard<std::mutex> lock(runs_mutex);
+                    runs.push_back(std::move(run));
+                }
+                catch (...) {
+                    fail();
+                    chunks.close();
+                }
+            }
+        });
+    }
+    reader.join();
+    for (auto && worker : workers) worker.join();
+    stats.sort_ms = since();
+    if (failure) std::rethrow_exception(failure);
+
+    stats.runs = runs.size();
+    for (auto && run : runs) stats.spilled += run.spilled();
+
+    Channel<std::string> buffers(4);
+    std::thread writer([&] {
+        std::string buffer;
+        try {
+            while (buffers.pop(buffer)) write_fully(out_fd, buffer.data(), buffer.size());
+        }
+        catch (...) {
+            fail();
+            buffers.close();
+        }
+    });
+
+    const std::size_t flush_bytes = 1 << 20;
+    std::string buffer;
+    buffer.reserve(flush_bytes + 32);
+    // returning false stops the merge: the writer failed and closed buffers
+    kway_merge(runs, [&](long long value) {
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        buffer.append(digits, end);
+        buffer.push_back('\n');
+        ++stats.numbers;
+        if (buffer.size() >= flush_bytes) {
+            if (!buffers.push(std::move(buffer))) return false;
+            buffer = std::string();
+            buffer.reserve(flush_bytes + 32);
+        }
+        return true;
+    });
+    if (!buffer.empty()) buffers.push(std::move(buffer));
+    buffers.close();
+    writer.join();
+    if (failure) std::rethrow_exception(failure);
+    stats.total_ms = since();
+    return stats;
+}
+
+#endif
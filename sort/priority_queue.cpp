@@ -0,0 +1,24 @@
+#include <iostream>
+#include <vector>
+#include <functional>
+
+#include "priority_queue.h"
+
+// the numbers come back smallest first, each pushed number's handle printed
+// as it goes in; then the first one pushed is taken out again with erase
+int main() {
+    int num;
+    PriorityQueue<int, std::greater<int>> queue;
+    std::vector<PriorityQueue<int, std::greater<int>>::Handle> handles;
+    while (std::cin >> num) {
+        handles.push_back(queue.push(num));
+    }
+    if (!handles.empty()) {
+        std::cout << "erasing " << queue.get(handles.front()) << std::endl;
+        queue.erase(handles.front());
+    }
+    while (!queue.empty()) {
+        std::cout << queue.top() << " ";
+        queue.pop();
+    }
+}
@@ -0,0 +1,285 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+
+// the heap of heapsort.h as a standalone queue, with two additions a
+// scheduler needs: every push returns a handle that stays valid until its
+// element leaves, and through a position map the element behind a handle
+// can be re-prioritized or erased in O(log n). like heapsort.h the top is
+// the largest by comp, so std::greater makes it a min-queue
+//
+// the heap is 0-based and each node has Arity children, at Arity * i + 1 on:
+// a wider node makes the heap shallower, so pushes and promotions compare
+// less, while pops compare more per level; 4 keeps a node's children within
+// one or two cache lines for small T
+template <typename T, typename Compare = std::less<T>, unsigned Arity = 4>
+class PriorityQueue {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+    public:
+    using Handle = std::size_t;
+
+    private:
+    struct Entry {
+        T value;
+        Handle handle;
+    };
+
+    std::vector<Entry> heap;
+    std::vector<std::size_t> position;  // handle -> index in heap, or npos once it has left
+    std::vector<Handle> released;       // handles free for reuse
+    Compare comp;
+
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    void place(std::size_t i, Entry && entry) {
+        position[entry.handle] = i;
+        heap[i] = std::move(entry);
+    }
+    Handle acquire();
+    void sift_up(std::size_t i);
+    void sift_down(std::size_t i);
+    void remove_at(std::size_t i);
+
+    public:
+    explicit PriorityQueue(Compare comp = Compare()) : comp(comp) {}
+
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+    const T & top() const { return heap.front().value; }
+    Handle top_handle() const { return heap.front().handle; }
+
+    Handle push(const T & value);
+    void pop();
+
+    bool contains(Handle handle) const { return handle < position.size() && position[handle] != npos; }
+    const T & get(Handle handle) const { return heap[position[handle]].value; }
+    // value must rank no lower than the one it replaces; with std::greater
+    // this is the decrease-key of a min-queue, and it only ever sifts up
+    void decrease_key(Handle handle, const T & value);
+    // any new value, sifted whichever way it has to go
+    void update(Handle handle, const T & value);
+    void erase(Handle handle);
+
+    // adds [first, last) at once and restores the heap bottom-up (Floyd):
+    // O(n + size()) instead of O(n log n) for as many pushes. the handles
+    // come back in input order
+    template <typename Iterator>
+    std::vector<Handle> heapify(Iterator first, Iterator last);
+};
+
+template <typename T, typename Compare, unsigned Arity>
+typename PriorityQueue<T, Compare, Arity>::Handle PriorityQueue<T, Compare, Arity>::acquire() {
+    if (!released.empty()) {
+        auto handle = released.back();
+        released.pop_back();
+        return handle;
+    }
+    position.push_back(npos);
+    return position.size() - 1;
+}
+
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::sift_up(std::size_t i) {
+    // the entry moves as a hole: parents come down into it, and it is
+    // written once, where it stops
+    Entry entry = std::move(heap[i]);
+    while (i > 0) {
+        auto parent = (i - 1) / Arity;
+        if (!comp(heap[parent].value, entry.value)) break;
+        place(i, std::move(heap[parent]));
+        i = parent;
+    }
+    place(i, std::move(entry));
+}
+
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::sift_down(std::size_t i) {
+    Entry entry = std::move(heap[i]);
+    auto n = heap.size();
+    while (true) {
+        auto first = Arity * i + 1;
+        if (first >= n) break;
+        auto last = (first + Arity < n) ? first + Arity : n;
+        auto child = first;
+        for (auto c = first + 1; c < last; ++c) {
+            if (comp(heap[child].value, heap[c].value)) child = c;
+        }
+        if (!comp(entry.value, heap[child].value)) break;
+        place(i, std::move(heap[child]));
+        i = child;
+    }
+    place(i, std::move(entry));
+}
+
+template <typename T, typename Compare, unsigned Arity>
+typename PriorityQueue<T, Compare, Arity>::Handle PriorityQueue<T, Compare, Arity>::push(const T & value) {
+    auto handle = acquire();
+    heap.push_back({ value, handle });
+    position[handle] = heap.size() - 1;
+    sift_up(heap.size() - 1);
+    return handle;
+}
+
+// Floyd's pop, as floydHeapify does it: the hole left at i sinks to a leaf
+// by pulling up the larger child at every level, one comparison per child
+// and none against the element that will fill it, then the last leaf moves
+// into it and sifts up, which is rarely far
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::remove_at(std::size_t i) {
+    auto handle = heap[i].handle;
+    position[handle] = npos;
+    released.push_back(handle);
+    auto n = heap.size() - 1;  // the last leaf is about to move
+    if (i == n) {
+        heap.pop_back();
+        return;
+    }
+    while (true) {
+        auto first = Arity * i + 1;
+        if (first >= n) break;
+        auto last = (first + Arity < n) ? first + Arity : n;
+        auto child = first;
+        for (auto c = first + 1; c < last; ++c) {
+            if (comp(heap[child].value, heap[c].value)) child = c;
+        }
+        place(i, std::move(heap[child]));
+        i = child;
+    }
+    place(i, std::move(heap.back()));
+    heap.pop_back();
+    sift_up(i);
+}
+
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::pop() {
+    if (heap.empty()) throw std::runtime_error("pop from an empty priority queue");
+    remove_at(0);
+}
+
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::decrease_key(Handle handle, const T & value) {
+    if (!contains(handle)) throw std::runtime_error("no element behind this handle");
+    auto i = position[handle];
+    if (comp(value, heap[i].value)) throw std::runtime_error("decrease_key would lower the priority");
+    heap[i].value = value;
+    sift_up(i);
+}
+
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::update(Handle handle, const T & value) {
+    if (!contains(handle)) throw std::runtime_error("no element behind this handle");
+    auto i = position[handle];
+    auto raised = comp(heap[i].value, value);
+    heap[i].value = value;
+    if (raised) sift_up(i);
+    else sift_down(i);
+}
+
+template <typename T, typename Compare, unsigned Arity>
+void PriorityQueue<T, Compare, Arity>::erase(Handle handle) {
+    if (!contains(handle)) throw std::runtime_error("no element behind this handle");
+    remove_at(position[handle]);
+}
+
+template <typename T, typename Compare, unsigned Arity>
+template <typename Iterator>
+std::vector<typename PriorityQueue<T, Compare, Arity>::Handle> PriorityQueue<T, Compare, Arity>::heapify(Iterator first, Iterator last) {
+    std::vector<Handle> handles;
+    auto count = std::size_t(std::distance(first, last));
+    heap.reserve(heap.size() + count);
+    handles.reserve(count);
+    for (; first != last; ++first) {
+        auto handle = acquire();
+        heap.push_back({ *first, handle });
+        position[handle] = heap.size() - 1;
+        handles.push_back(handle);
+    }
+    // every node past the last parent is a leaf, already a heap on its own
+    if (heap.size() > 1) {
+        for (auto i = (heap.size() - 2) / Arity + 1; i-- > 0; ) sift_down(i);
+    }
+    return handles;
+}
+
+// a min-queue for unsigned integer keys that never go below the last key
+// popped, as in Dijkstra's algorithm or an event simulation. bucket b holds
+// the keys whose highest bit differing from the last popped key is bit b - 1
+// (bucket 0 the keys equal to it); a pop that finds bucket 0 empty takes the
+// smallest key of the first non-empty bucket as the new last and spreads
+// that bucket over the lower ones. a key only ever moves to lower buckets,
+// so a push and its pop cost O(log C) together for keys spanning C, with no
+// comparisons between elements
+template <typename Value>
+class RadixHeap {
+    std::vector<std::pair<std::uint64_t, Value>> buckets[65];
+    std::uint64_t last;
+    std::size_t count;
+
+    static unsigned bucket_of(std::uint64_t key, std::uint64_t last) {
+        if (key == last) return 0;
+#if defined(__GNUC__)
+        return 64 - unsigned(__builtin_clzll(key ^ last));
+#else
+        unsigned bucket = 0;
+        for (auto bits = key ^ last; bits; bits >>= 1) ++bucket;
+        return bucket;
+#endif
+    }
+    void refill();
+
+    public:
+    RadixHeap() : last(0), count(0) {}
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+
+    void push(std::uint64_t key, const Value & value);
+    // the smallest key and its value; top() may refill bucket 0 first
+    const std::pair<std::uint64_t, Value> & top();
+    void pop();
+};
+
+template <typename Value>
+void RadixHeap<Value>::push(std::uint64_t key, const Value & value) {
+    if (key < last) throw std::runtime_error("radix heap keys cannot go below the last key popped");
+    buckets[bucket_of(key, last)].emplace_back(key, value);
+    ++count;
+}
+
+template <typename Value>
+void RadixHeap<Value>::refill() {
+    if (!buckets[0].empty()) return;
+    unsigned b = 1;
+    while (buckets[b].empty()) ++b;
+    auto smallest = buckets[b].front().first;
+    for (auto && entry : buckets[b]) {
+        if (entry.first < smallest) smallest = entry.first;
+    }
+    last = smallest;
+    for (auto && entry : buckets[b]) buckets[bucket_of(entry.first, last)].push_back(std::move(entry));
+    buckets[b].clear();
+}
+
+template <typename Value>
+const std::pair<std::uint64_t, Value> & RadixHeap<Value>::top() {
+    if (count == 0) throw std::runtime_error("top of an empty radix heap");
+    refill();
+    return buckets[0].back();
+}
+
+template <typename Value>
+void RadixHeap<Value>::pop() {
+    if (count == 0) throw std::runtime_error("pop from an empty radix heap");
+    refill();
+    buckets[0].pop_back();
+    --count;
+}
+
+#endif
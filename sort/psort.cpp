@@ -0,0 +1,59 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "pipeline.h"
+
+// sorts the integers of a file, or stdin, one per line, reading, sorting,
+// merging and writing all at once; -v reports when each stage finished
+// usage: psort [-j threads] [-c chunk MiB] [-m memory MiB] [-T tmpdir] [-o output] [-v] [input]
+int main(int argc, char * argv[]) {
+    PipelineOptions options;
+    std::string input = "-", output;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        auto more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "-j") && more) options.threads = unsigned(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "-c") && more) options.chunk_bytes = std::strtoull(argv[++i], nullptr, 10) << 20;
+        else if (!std::strcmp(argv[i], "-m") && more) options.memory_bytes = std::strtoull(argv[++i], nullptr, 10) << 20;
+        else if (!std::strcmp(argv[i], "-T") && more) options.temp_directory = argv[++i];
+        else if (!std::strcmp(argv[i], "-o") && more) output = argv[++i];
+        else if (!std::strcmp(argv[i], "-v")) verbose = true;
+        else if (argv[i][0] == '-' && argv[i][1]) {
+            std::cerr << "usage: psort [-j threads] [-c chunk MiB] [-m memory MiB] [-T tmpdir] [-o output] [-v] [input]" << std::endl;
+            return 1;
+        }
+        else input = argv[i];
+    }
+    if (options.chunk_bytes == 0) options.chunk_bytes = 1 << 20;
+
+    int in = (input == "-") ? STDIN_FILENO : ::open(input.c_str(), O_RDONLY);
+    if (in < 0) {
+        std::cerr << "cannot open " << input << std::endl;
+        return 1;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    int out = output.empty() ? STDOUT_FILENO : ::open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        std::cerr << "cannot open " << output << std::endl;
+        return 1;
+    }
+
+    try {
+        auto stats = pipelined_sort(in, out, options);
+        if (verbose) {
+            std::cerr << "psort: " << stats.numbers << " numbers, " << stats.bytes << " bytes, " << stats.runs << " runs ("
+                      << stats.spilled << " spilled); read done at " << stats.read_ms << " ms, sorted at " << stats.sort_ms
+                      << " ms, written at " << stats.total_ms << " ms" << std::endl;
+        }
+    }
+    catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef QUICKSORT_H
+#define QUICKSORT_H
+
+#include <vector>
+#include <utility>
+
+// moves vec[low], the pivot, to its final position and returns it: nothing
+// before it is larger and nothing after it is smaller
+template <typename T>
+int partition(std::vector<T> & vec, int low, int high) {
+    auto first = low;
+    auto last = high;
+    auto key = vec[first]; // pivot
+    while (first < last) {
+        // find the first element smaller than pivot from the right
+        while (first < last && vec[last] >= key) --last;
+        std::swap(vec[first], vec[last]);
+
+        // find the first element larger than pivot from the left
+        while (first < last && vec[first] <= key) ++first;
+        std::swap(vec[first], vec[last]);
+    }
+    return first;
+}
+
+template <typename T>
+void quicksort(std::vector<T> & vec, int low, int high) {
+    if (low > high) return;
+    auto first = partition(vec, low, high);
+    // now all elements larger than pivot are on its right, unsorted 
+    // and all elements smaller than pivot are on its left, unsorted
+    quicksort(vec, low, first - 1); // sort the left side
+    quicksort(vec, first + 1, high); // sort the right side
+}
+
+#endif
@@ -0,0 +1,15 @@
+#include <iostream>
+#include <vector>
+
+#include "radixsort.h"
+
+int main() {
+    int num;
+    std::vector<int> vec;
+    std::vector<int> temp;
+    while (std::cin >> num) {
+        vec.emplace_back(num);
+    }
+    radixsort(vec, temp);
+    for (auto && i : vec) { std::cout << i << " "; }
+}
@@ -0,0 +1,36 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+// least significant digit first, one byte per pass, stable, O(n * sizeof(T)).
+// signed keys get their sign bit flipped so that negatives order first, and a
+// pass whose byte is the same in every key is skipped
+template <typename T>
+void radixsort(std::vector<T> & vec, std::vector<T> & temp) {
+    static_assert(std::is_integral<T>::value, "radixsort needs integer keys");
+    if (vec.size() < 2) return;
+    using U = typename std::make_unsigned<T>::type;
+    const U flip = std::is_signed<T>::value ? U(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+    temp.resize(vec.size());
+
+    for (unsigned shift = 0; shift < sizeof(T) * 8; shift += 8) {
+        std::size_t counts[256] = {};
+        for (auto && i : vec) ++counts[((U(i) ^ flip) >> shift) & 0xff];
+        if (counts[((U(vec[0]) ^ flip) >> shift) & 0xff] == vec.size()) continue;
+
+        // counts become the first position of each digit
+        std::size_t position = 0;
+        for (auto && count : counts) {
+            auto next = position + count;
+            count = position;
+            position = next;
+        }
+        for (auto && i : vec) temp[counts[((U(i) ^ flip) >> shift) & 0xff]++] = i;
+        vec.swap(temp);
+    }
+}
+
+#endif
@@ -0,0 +1,14 @@
+#include <iostream>
+#include <vector>
+
+#include "samplesort.h"
+
+int main() {
+    int num;
+    std::vector<int> vec;
+    while (std::cin >> num) {
+        vec.emplace_back(num);
+    }
+    samplesort(vec);
+    for (auto && i : vec) { std::cout << i << " "; }
+}
@@ -0,0 +1,275 @@
+#ifndef SAMPLESORT_H
+#define SAMPLESORT_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <csignal>
+#include <type_traits>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "sort.h"
+
+// sample sort: a sorted sample picks bucket boundaries (splitters), one pass
+// sends every element to its bucket, and the buckets, each small enough to
+// stay in cache, are sorted independently. it reads and writes the input
+// about three times whatever n is, where a mergesort makes log n passes.
+// distribution keeps input order inside a bucket, so with `stable` set (the
+// buckets then go through naturalmergesort) equal elements keep their order
+//
+// the phases are the ones a distributed run would have: sample -> splitters,
+// classify -> bucket counts, exchange buckets, sort locally. samplesort()
+// runs them on threads, process_samplesort() on processes sharing memory
+
+// finds an element's bucket without a branch: the splitters are laid out as
+// an implicit search tree (children of j at 2j and 2j + 1), and each level
+// adds the outcome of one comparison to the index
+template <typename T>
+class Classifier {
+    std::vector<T> tree;  // tree[1..buckets - 1]
+    std::size_t buckets;
+    unsigned levels;
+
+    void build(const std::vector<T> & splitters, std::size_t node, std::size_t & next) {
+        if (node >= buckets) return;
+        build(splitters, 2 * node, next);
+        tree[node] = splitters[next++];
+        build(splitters, 2 * node + 1, next);
+    }
+
+    public:
+    // splitters are sorted and number a power of two minus one
+    explicit Classifier(const std::vector<T> & splitters) : tree(splitters.size() + 1), buckets(splitters.size() + 1), levels(0) {
+        while ((std::size_t(1) << levels) < buckets) ++levels;
+        std::size_t next = 0;
+        build(splitters, 1, next);
+    }
+
+    std::size_t size() const { return buckets; }
+    // bucket b holds the elements in (splitter b - 1, splitter b]
+    std::size_t operator()(const T & value) const {
+        std::size_t j = 1;
+        for (unsigned level = 0; level < levels; ++level) j = 2 * j + std::size_t(tree[j] < value);
+        return j - buckets;
+    }
+};
+
+// a power of two, about one bucket per 32K elements so each one sorts in
+// cache, and enough of them to keep every worker busy
+inline std::size_t samplesort_buckets(std::size_t n, unsigned workers) {
+    std::size_t buckets = 2;
+    while (buckets < 4096 && (buckets < 8 * std::size_t(workers) || buckets * 32768 < n)) buckets *= 2;
+    return buckets;
+}
+
+// `oversampling` candidates per bucket are drawn and sorted, and every
+// oversampling-th of them becomes a splitter, which evens out bucket sizes
+template <typename T>
+Classifier<T> choose_splitters(const std::vector<T> & vec, std::size_t buckets, std::size_t oversampling = 16) {
+    std::mt19937_64 gen(0x5eed);
+    std::uniform_int_distribution<std::size_t> position(0, vec.size() - 1);
+    std::vector<T> sample(buckets * oversampling);
+    for (auto && i : sample) i = vec[position(gen)];
+    sort(sample);
+    std::vector<T> splitters(buckets - 1);
+    for (std::size_t i = 0; i + 1 < buckets; ++i) splitters[i] = sample[(i + 1) * oversampling - 1];
+    return Classifier<T>(splitters);
+}
+
+// classify [first, last) of vec: oracle[i - first] is the bucket of vec[i]
+template <typename T>
+void classify(const T * vec, std::size_t first, std::size_t last, const Classifier<T> & classifier,
+              std::uint16_t * oracle, std::size_t * counts) {
+    for (auto i = first; i < last; ++i) {
+        auto bucket = classifier(vec[i]);
+        oracle[i - first] = std::uint16_t(bucket);
+        ++counts[bucket];
+    }
+}
+
+// where each worker writes inside each bucket: counts[w * buckets + b] become
+// offsets, ordered by bucket and then by worker, which keeps the input order
+inline void bucket_offsets(std::size_t * counts, unsigned workers, std::size_t buckets, std::size_t * starts) {
+    std::size_t position = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+        starts[b] = position;
+        for (unsigned w = 0; w < workers; ++w) {
+            auto count = counts[w * buckets + b];
+            counts[w * buckets + b] = position;
+            position += count;
+        }
+    }
+    starts[buckets] = position;
+}
+
+template <typename T>
+void distribute(const T * vec, std::size_t first, std::size_t last, const std::uint16_t * oracle, std::size_t * offsets, T * out) {
+    for (auto i = first; i < last; ++i) out[offsets[oracle[i - first]]++] = vec[i];
+}
+
+// sorts out[first, last) through a vector the size of one bucket, which stays in cache
+template <typename T>
+void sort_bucket(T * out, std::size_t first, std::size_t last, bool stable, std::vector<T> & local, std::vector<T> & temp) {
+    if (last - first < 2) return;
+    local.assign(out + first, out + last);
+    if (stable) {
+        temp.resize(local.size());
+        naturalmergesort(local, temp);
+    }
+    else sort(local);
+    std::copy(local.begin(), local.end(), out + first);
+}
+
+template <typename T>
+void samplesort(std::vector<T> & vec, unsigned threads = std::thread::hardware_concurrency(), bool stable = false) {
+    auto n = vec.size();
+    if (threads == 0) threads = 1;
+    if (n < 65536 || threads == 1) {
+        if (stable) {
+            std::vector<T> temp(n);
+            naturalmergesort(vec, temp);
+        }
+        else sort(vec);
+        return;
+    }
+    auto buckets = samplesort_buckets(n, threads);
+    auto classifier = choose_splitters(vec, buckets);
+
+    std::vector<T> out(n);
+    std::vector<std::size_t> counts(threads * buckets), starts(buckets + 1);
+    std::vector<std::vector<std::uint16_t>> oracles(threads);
+    auto chunk = [&](unsigned t) { return std::make_pair(n * t / threads, n * (t + 1) / threads); };
+    auto run = [&](auto work) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(work, t);
+        for (auto && worker : workers) worker.join();
+    };
+
+    run([&](unsigned t) {
+        auto range = chunk(t);
+        oracles[t].resize(range.second - range.first);
+        classify(vec.data(), range.first, range.second, classifier, oracles[t].data(), &counts[t * buckets]);
+    });
+    bucket_offsets(counts.data(), threads, buckets, starts.data());
+    run([&](unsigned t) {
+        auto range = chunk(t);
+        distribute(vec.data(), range.first, range.second, oracles[t].data(), &counts[t * buckets], out.data());
+    });
+
+    // buckets are handed out one at a time, so a large one does not hold up the rest
+    std::atomic<std::size_t> next(0);
+    run([&](unsigned) {
+        std::vector<T> local, temp;
+        for (auto b = next++; b < buckets; b = next++) {
+            sort_bucket(out.data(), starts[b], starts[b + 1], stable, local, temp);
+        }
+    });
+    vec.swap(out);
+}
+
+// the same phases on worker processes: splitters are chosen before the
+// fork, each worker classifies its own chunk, publishes its counts and
+// writes its elements straight into the other workers' buckets in a shared
+// mapping, then sorts the buckets that start in its share of the output.
+// T must be trivially copyable, as it crosses process boundaries as bytes
+template <typename T>
+void process_samplesort(std::vector<T> & vec, unsigned processes, bool stable = false) {
+    static_assert(std::is_trivially_copyable<T>::value, "process_samplesort moves elements as raw bytes");
+    auto n = vec.size();
+    if (processes == 0) processes = 1;
+    if (n < 65536 || processes == 1) {
+        samplesort(vec, 1, stable);
+        return;
+    }
+    auto buckets = samplesort_buckets(n, processes);
+    auto classifier = choose_splitters(vec, buckets);
+
+    // the output, every worker's counts, and a barrier, all in one shared mapping
+    auto out_bytes = (n * sizeof(T) + 63) / 64 * 64;
+    auto counts_bytes = (processes * buckets * sizeof(std::size_t) + 63) / 64 * 64;
+    auto length = out_bytes + counts_bytes + sizeof(pthread_barrier_t);
+    auto shared = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) throw std::runtime_error("process_samplesort: cannot map shared memory");
+    auto out = static_cast<T *>(shared);
+    auto counts = reinterpret_cast<std::size_t *>(static_cast<char *>(shared) + out_bytes);
+    auto barrier = reinterpret_cast<pthread_barrier_t *>(static_cast<char *>(shared) + out_bytes + counts_bytes);
+    std::memset(counts, 0, counts_bytes);
+    pthread_barrierattr_t attributes;
+    pthread_barrierattr_init(&attributes);
+    pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(barrier, &attributes, processes);
+    pthread_barrierattr_destroy(&attributes);
+
+    std::vector<pid_t> workers;
+    for (unsigned w = 0; w < processes; ++w) {
+        auto pid = ::fork();
+        if (pid < 0) {
+            for (auto worker : workers) ::kill(worker, SIGKILL);
+            for (auto worker : workers) ::waitpid(worker, nullptr, 0);
+            pthread_barrier_destroy(barrier);
+            ::munmap(shared, length);
+            throw std::runtime_error("process_samplesort: fork failed");
+        }
+        if (pid == 0) {
+            // the input is this process's copy-on-write view of vec
+            auto first = n * w / processes, last = n * (w + 1) / processes;
+            std::vector<std::uint16_t> oracle(last - first);
+            classify(vec.data(), first, last, classifier, oracle.data(), counts + w * buckets);
+            pthread_barrier_wait(barrier);
+
+            // every worker derives the same offsets from the published counts
+            std::vector<std::size_t> offsets(counts, counts + processes * buckets), starts(buckets + 1);
+            bucket_offsets(offsets.data(), processes, buckets, starts.data());
+            distribute(vec.data(), first, last, oracle.data(), &offsets[w * buckets], out);
+            pthread_barrier_wait(barrier);
+
+            std::vector<T> local, temp;
+            for (std::size_t b = 0; b < buckets; ++b) {
+                if (starts[b] < first || starts[b] >= last) continue;
+                sort_bucket(out, starts[b], starts[b + 1], stable, local, temp);
+            }
+            ::_exit(0);
+        }
+        workers.push_back(pid);
+    }
+
+    // a worker that dies would leave the others waiting at the barrier, so
+    // they are polled rather than waited on in turn; only our own pids are
+    // reaped, never another child of the caller
+    bool failed = false;
+    auto pending = workers;
+    while (!pending.empty()) {
+        auto before = pending.size();
+        for (std::size_t i = 0; i < pending.size(); ) {
+            int status = 0;
+            auto pid = ::waitpid(pending[i], &status, WNOHANG);
+            if (pid == 0) {
+                ++i;
+                continue;
+            }
+            // gone from the list before any kill, as its pid may be reused
+            pending[i] = pending.back();
+            pending.pop_back();
+            if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                if (!failed) for (auto worker : pending) ::kill(worker, SIGKILL);
+                failed = true;
+            }
+        }
+        if (pending.size() == before) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (!failed) std::copy(out, out + n, vec.begin());
+    pthread_barrier_destroy(barrier);
+    ::munmap(shared, length);
+    if (failed) throw std::runtime_error("process_samplesort: a worker failed");
+}
+
+#endif
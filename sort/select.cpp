@@ -0,0 +1,22 @@
+#include <iostream>
+#include <vector>
+
+#include "select.h"
+
+int main() {
+    int num;
+    std::vector<int> vec;
+    while (std::cin >> num) {
+        vec.emplace_back(num);
+    }
+    if (vec.empty()) return 0;
+    int middle = (vec.size() - 1) / 2;
+    nth_element(vec, 0, vec.size() - 1, middle);
+    std::cout << "median: " << vec[middle] << std::endl;
+
+    partial_sort(vec, 3);
+    std::cout << "smallest: ";
+    for (std::size_t i = 0; i < 3 && i < vec.size(); ++i) { std::cout << vec[i] << " "; }
+    std::cout << std::endl << "largest: ";
+    for (auto && i : top_k(vec, 3)) { std::cout << i << " "; }
+}
@@ -0,0 +1,156 @@
+#ifndef SELECT_H
+#define SELECT_H
+
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "insertionsort.h"
+#include "quicksort.h"
+#include "heapsort.h"
+
+// the guaranteed linear fallback: the pivot is the median of the medians of
+// groups of five, and the partition is three-way, so runs of equal keys
+// cannot make it go quadratic either
+template <typename T>
+void median_of_medians(std::vector<T> & vec, int low, int high, int nth) {
+    while (high - low + 1 > 5) {
+        // the median of each group of five is gathered at the front of the range
+        int count = 0;
+        for (int group = low; group <= high; group += 5) {
+            auto end = (group + 4 < high) ? group + 4 : high;
+            insertionsort(vec, group, end);
+            std::swap(vec[low + count], vec[group + (end - group) / 2]);
+            ++count;
+        }
+        auto middle = low + (count - 1) / 2;
+        median_of_medians(vec, low, low + count - 1, middle);
+        auto pivot = vec[middle];
+
+        // [low, less) < pivot, [less, i) == pivot, (greater, high] > pivot
+        auto less = low, i = low, greater = high;
+        while (i <= greater) {
+            if (vec[i] < pivot) std::swap(vec[less++], vec[i++]);
+            else if (pivot < vec[i]) std::swap(vec[i], vec[greater--]);
+            else ++i;
+        }
+        if (nth < less) high = less - 1;
+        else if (nth > greater) low = greater + 1;
+        else return;
+    }
+    insertionsort(vec, low, high);
+}
+
+// rearranges vec[low..high] so that vec[nth] is the element a full sort would
+// put there, with nothing larger before it and nothing smaller after it.
+// quickselect on the quicksort partition with a median-of-three pivot; if two
+// rounds in a row fail to halve the range, median_of_medians takes over,
+// which keeps the worst case at O(n)
+template <typename T>
+void nth_element(std::vector<T> & vec, int low, int high, int nth) {
+    auto size = high - low + 1;
+    auto rounds = 0;
+    while (high - low + 1 > 16) {
+        if (rounds == 2) {
+            if (2 * (high - low + 1) > size) {
+                median_of_medians(vec, low, high, nth);
+                return;
+            }
+            size = high - low + 1;
+            rounds = 0;
+        }
+        ++rounds;
+
+        // the median of the ends and the middle becomes vec[low], the pivot partition() expects
+        auto mid = low + (high - low) / 2;
+        if (vec[mid] < vec[low]) std::swap(vec[mid], vec[low]);
+        if (vec[high] < vec[mid]) std::swap(vec[high], vec[mid]);
+        if (vec[mid] < vec[low]) std::swap(vec[mid], vec[low]);
+        std::swap(vec[low], vec[mid]);
+
+        auto position = partition(vec, low, high);
+        if (nth == position) return;
+        if (nth < position) high = position - 1;
+        else low = position + 1;
+    }
+    insertionsort(vec, low, high);
+}
+
+// keeps the k largest values by comp pushed so far in O(k) memory, each push
+// O(log k). the heap is the 1-based layout of heapsort.h, ordered by the
+// inverse of comp so that its top is the smallest value kept
+template <typename T, typename Compare = std::less<T>>
+class TopK {
+    struct Inverse {
+        Compare comp;
+        bool operator()(const T & lhs, const T & rhs) const { return comp(rhs, lhs); }
+    };
+
+    std::vector<T> heap;  // heap[0] is the unused slot
+    std::size_t k;
+    Inverse inverse;
+
+    public:
+    explicit TopK(std::size_t count, Compare comp = Compare()) : heap(1), k(count), inverse{ comp } { heap.reserve(k + 1); }
+
+    void push(const T & value);
+    std::size_t size() const { return heap.size() - 1; }
+    // the values kept, largest first
+    std::vector<T> sorted() const;
+};
+
+template <typename T, typename Compare>
+void TopK<T, Compare>::push(const T & value) {
+    if (k == 0) return;
+    if (size() < k) {
+        // sift the new leaf up while it is smaller than its parent
+        heap.push_back(value);
+        for (auto child = size(); child > 1 && inverse(heap[child / 2], heap[child]); child /= 2) {
+            std::swap(heap[child], heap[child / 2]);
+        }
+    }
+    else if (inverse.comp(heap[1], value)) {
+        // the smallest value kept makes way
+        heap[1] = value;
+        maxHeapify(heap, 1, int(k), inverse);
+    }
+}
+
+template <typename T, typename Compare>
+std::vector<T> TopK<T, Compare>::sorted() const {
+    auto result = heap;
+    heapSort(result, int(size()), inverse);
+    result.erase(result.begin());
+    return result;
+}
+
+// the k largest values of vec, largest first, in O(n log k)
+template <typename T>
+std::vector<T> top_k(const std::vector<T> & vec, std::size_t k) {
+    TopK<T> top(k);
+    for (auto && i : vec) top.push(i);
+    return top.sorted();
+}
+
+// puts the k smallest values of vec, in order, at its front in O(n log k);
+// the rest follow in no particular order. a bounded max-heap holds the k
+// smallest seen so far, and each value that beats its top swaps places with it
+template <typename T>
+void partial_sort(std::vector<T> & vec, std::size_t k) {
+    if (k > vec.size()) k = vec.size();
+    if (k == 0) return;
+    std::vector<T> heap(1);
+    heap.reserve(k + 1);
+    heap.insert(heap.end(), vec.begin(), vec.begin() + k);
+    for (int i = int(k) / 2; i > 0; --i) maxHeapify(heap, i, int(k));
+    for (auto i = k; i < vec.size(); ++i) {
+        if (vec[i] < heap[1]) {
+            std::swap(vec[i], heap[1]);
+            maxHeapify(heap, 1, int(k));
+        }
+    }
+    heapSort(heap, int(k));
+    std::move(heap.begin() + 1, heap.end(), vec.begin());
+}
+
+#endif
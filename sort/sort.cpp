@@ -0,0 +1,14 @@
+#include <iostream>
+#include <vector>
+
+#include "sort.h"
+
+int main() {
+    int num;
+    std::vector<int> vec;
+    while (std::cin >> num) {
+        vec.emplace_back(num);
+    }
+    sort(vec, sort_thresholds(), &std::cerr);
+    for (auto && i : vec) { std::cout << i << " "; }
+}
@@ -0,0 +1,187 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+#include "insertionsort.h"
+#include "mergesort.h"
+#include "quicksort.h"
+#include "countingsort.h"
+#include "radixsort.h"
+#include "parallel_quicksort.h"
+
+enum class SortKernels { insertion, natural_merge, counting, radix, merge, quick };
+
+inline const char * kernel_name(SortKernels kernel) {
+    switch (kernel) {
+        case SortKernels::insertion: return "insertionsort";
+        case SortKernels::natural_merge: return "naturalmergesort";
+        case SortKernels::counting: return "countingsort";
+        case SortKernels::radix: return "radixsort";
+        case SortKernels::merge: return "mergesort";
+        case SortKernels::quick: return "quicksort";
+    }
+    return "";
+}
+
+// where sort() switches kernels. the defaults suit a typical x86-64 host;
+// benchmark/calibrate_sort measures this one and writes a file for load()
+struct SortThresholds {
+    std::size_t insertion_limit = 32;   // insertion sort up to this many elements
+    double presorted = 0.02;            // merge the runs when at most this share of sampled neighbours is out of order, or at least 1 - this
+    double counting_range = 2;          // counting sort integer keys when max - min < counting_range * n
+    std::size_t radix_min = 2048;       // radix sort integer keys from this many elements
+    double duplicates = 1;              // mergesort instead of quicksort once this share of the sample repeats; 1 for never
+    std::size_t sample = 128;           // elements looked at before choosing
+
+    bool load(const std::string & path);
+    void save(std::ostream & os) const;
+};
+
+inline bool SortThresholds::load(const std::string & path) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line, name;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        if (!(iss >> name) || name[0] == '#') continue;
+        if (name == "insertion_limit") iss >> insertion_limit;
+        else if (name == "presorted") iss >> presorted;
+        else if (name == "counting_range") iss >> counting_range;
+        else if (name == "radix_min") iss >> radix_min;
+        else if (name == "duplicates") iss >> duplicates;
+        else if (name == "sample") iss >> sample;
+    }
+    return true;
+}
+
+inline void SortThresholds::save(std::ostream & os) const {
+    os << "insertion_limit " << insertion_limit << "\n"
+       << "presorted " << presorted << "\n"
+       << "counting_range " << counting_range << "\n"
+       << "radix_min " << radix_min << "\n"
+       << "duplicates " << duplicates << "\n"
+       << "sample " << sample << "\n";
+}
+
+// the thresholds sort() uses by default: the built-in ones, or the file
+// named by SORT_THRESHOLDS when that is set
+inline SortThresholds & sort_thresholds() {
+    static SortThresholds thresholds = [] {
+        SortThresholds t;
+        if (auto path = std::getenv("SORT_THRESHOLDS")) {
+            if (!t.load(path)) std::cerr << "sort: cannot read " << path << ", using defaults" << std::endl;
+        }
+        return t;
+    }();
+    return thresholds;
+}
+
+// what sort() saw and what it picked
+struct SortDecision {
+    SortKernels kernel;
+    std::size_t n;
+    double descents;    // sampled share of neighbours out of order
+    double duplicates;  // sampled share of values seen before
+    double range;       // sampled max - min for integer keys, -1 otherwise
+};
+
+inline std::ostream & operator<<(std::ostream & os, const SortDecision & decision) {
+    return os << "sort: n=" << decision.n << " descents=" << decision.descents << " duplicates=" << decision.duplicates
+              << " range=" << decision.range << " -> " << kernel_name(decision.kernel);
+}
+
+// reads `sample` evenly spaced neighbour pairs, so it costs the same at any n
+template <typename T>
+SortDecision sample_input(const std::vector<T> & vec, std::size_t sample) {
+    SortDecision decision = { SortKernels::quick, vec.size(), 0, 0, -1 };
+    auto n = vec.size();
+    if (n < 2) return decision;
+    auto m = std::max<std::size_t>(std::min(sample, n - 1), 1);
+    std::vector<T> picked;
+    picked.reserve(m);
+    std::size_t descents = 0;
+    for (std::size_t i = 0; i < m; ++i) {
+        auto p = i * (n - 1) / m;
+        if (vec[p + 1] < vec[p]) ++descents;
+        picked.push_back(vec[p]);
+    }
+    decision.descents = double(descents) / m;
+
+    std::vector<T> temp(m);
+    mergesort(picked, 0, int(m) - 1, temp);
+    std::size_t repeats = 0;
+    for (std::size_t i = 1; i < m; ++i) {
+        if (!(picked[i - 1] < picked[i])) ++repeats;
+    }
+    decision.duplicates = double(repeats) / m;
+    if constexpr (std::is_integral<T>::value) decision.range = double(picked.back()) - double(picked.front());
+    return decision;
+}
+
+// integer keys skip comparisons altogether when the range or the size allows;
+// returns false when the comparison kernels should handle vec instead
+template <typename T>
+bool sort_integers(std::vector<T> & vec, SortDecision & decision, const SortThresholds & thresholds, std::vector<T> & temp) {
+    if constexpr (std::is_integral<T>::value) {
+        // the sampled range can only be narrower than the real one, which
+        // countingsort checks before it commits to anything
+        auto range = thresholds.counting_range * vec.size();
+        if (decision.range < range && countingsort(vec, std::size_t(range))) {
+            decision.kernel = SortKernels::counting;
+            return true;
+        }
+        if (vec.size() >= thresholds.radix_min) {
+            decision.kernel = SortKernels::radix;
+            radixsort(vec, temp);
+            return true;
+        }
+    }
+    return false;
+}
+
+// the front door over the kernels in this directory: samples the input, picks
+// the kernel that suits it and reports the choice, to `log` as well if given
+template <typename T>
+SortDecision sort(std::vector<T> & vec, const SortThresholds & thresholds = sort_thresholds(), std::ostream * log = nullptr) {
+    auto n = vec.size();
+    SortDecision decision = { SortKernels::insertion, n, 0, 0, -1 };
+    if (n > thresholds.insertion_limit) decision = sample_input(vec, thresholds.sample);
+
+    std::vector<T> temp;
+    auto ordered = [&](double limit) { return decision.descents <= limit || decision.descents >= 1 - limit; };
+    if (n <= thresholds.insertion_limit) {
+        insertionsort(vec);
+    }
+    else if (ordered(thresholds.presorted)) {
+        decision.kernel = SortKernels::natural_merge;
+        temp.resize(n);
+        naturalmergesort(vec, temp);
+    }
+    else if (!sort_integers(vec, decision, thresholds, temp)) {
+        // mostly ordered input needs no mergesort here: the median-of-three
+        // pivot of bounded_quicksort is at its best on it
+        if (decision.duplicates >= thresholds.duplicates) {
+            decision.kernel = SortKernels::merge;
+            temp.resize(n);
+            mergesort(vec, 0, int(n) - 1, temp);
+        }
+        else {
+            // median-of-three pivots with a depth budget: inputs the sample
+            // missed, such as zigzags, cannot drive it quadratic or deep
+            decision.kernel = SortKernels::quick;
+            bounded_quicksort(vec, 0, int(n) - 1);
+        }
+    }
+    if (log) *log << decision << std::endl;
+    return decision;
+}
+
+#endif
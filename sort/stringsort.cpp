@@ -0,0 +1,41 @@
+// sorts the lines of a file, or of stdin, and writes them to stdout
+// usage: stringsort [--multikey | --radix | --merge] [--lcp] [file]
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include <memory>
+
+#include "stringsort.h"
+#include "lines.h"
+
+int main(int argc, char * argv[]) {
+    std::string algorithm = "radix", path;
+    bool print_lcp = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--multikey" || arg == "--radix" || arg == "--merge") algorithm = arg.substr(2);
+        else if (arg == "--lcp") print_lcp = true;
+        else path = arg;
+    }
+
+    try {
+        auto lines = (path.empty()) ? std::make_unique<Lines>(std::cin) : std::make_unique<Lines>(path);
+        auto & vec = lines->views();
+        std::vector<std::size_t> lcp;
+        auto output = (print_lcp) ? &lcp : nullptr;
+        if (algorithm == "multikey") multikey_quicksort(vec, output);
+        else if (algorithm == "merge") lcp_mergesort(vec, output);
+        else msd_radixsort(vec, output);
+
+        for (std::size_t i = 0; i < vec.size(); ++i) {
+            // with --lcp every line is prefixed by its LCP with the line before
+            if (print_lcp) std::printf("%zu\t", lcp[i]);
+            std::fwrite(vec[i].data(), 1, vec[i].size(), stdout);
+            std::fputc('\n', stdout);
+        }
+    }
+    catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
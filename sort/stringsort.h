@@ -0,0 +1,259 @@
+#ifndef STRINGSORT_H
+#define STRINGSORT_H
+
+#include <vector>
+#include <string_view>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+
+// string kernels over string_views, so the characters themselves never move.
+// each one knows how many leading characters the strings in a range share,
+// and never compares those again; each can also report the LCP array, where
+// lcp[i] is the length of the longest common prefix of sorted[i - 1] and
+// sorted[i] (lcp[0] is 0)
+//
+// inside the kernels `lcp` points at the LCP entry of the first string of the
+// range; a call fills the entries of the strings after the first, and the
+// caller the boundaries between the ranges it splits into
+
+// the character at depth, or -1 past the end, so shorter strings sort first
+inline int char_at(std::string_view s, std::size_t depth) {
+    return (depth < s.size()) ? int(static_cast<unsigned char>(s[depth])) : -1;
+}
+
+// how many characters lhs and rhs share from depth on
+inline std::size_t common_prefix(std::string_view lhs, std::string_view rhs, std::size_t depth) {
+    auto length = (lhs.size() < rhs.size()) ? lhs.size() : rhs.size();
+    auto i = depth;
+    while (i < length && lhs[i] == rhs[i]) ++i;
+    return i - depth;
+}
+
+// for the short ranges the other kernels end on; the first depth characters
+// of every string in the range are known to be equal
+inline void insertionsort(std::string_view * a, std::size_t n, std::size_t depth, std::size_t * lcp) {
+    for (std::size_t i = 1; i < n; ++i) {
+        auto pivot = a[i];
+        auto j = i;
+        for (; j > 0; --j) {
+            auto h = depth + common_prefix(a[j - 1], pivot, depth);
+            if (char_at(a[j - 1], h) <= char_at(pivot, h)) break;
+            a[j] = a[j - 1];
+        }
+        a[j] = pivot;
+    }
+    if (!lcp) return;
+    for (std::size_t i = 1; i < n; ++i) lcp[i] = depth + common_prefix(a[i - 1], a[i], depth);
+}
+
+// up to eight characters from depth packed big-endian into one number, and
+// how many there were: comparing two chunks compares those characters at once
+struct Chunk {
+    std::uint64_t bytes;
+    unsigned length;
+
+    bool operator<(const Chunk & rhs) const { return bytes < rhs.bytes || (bytes == rhs.bytes && length < rhs.length); }
+    bool operator==(const Chunk & rhs) const { return bytes == rhs.bytes && length == rhs.length; }
+};
+
+inline Chunk chunk_at(std::string_view s, std::size_t depth) {
+    Chunk chunk = { 0, 0 };
+    if (depth >= s.size()) return chunk;
+    chunk.length = unsigned((s.size() - depth < 8) ? s.size() - depth : 8);
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (chunk.length == 8) {
+        std::memcpy(&chunk.bytes, s.data() + depth, 8);
+        chunk.bytes = __builtin_bswap64(chunk.bytes);
+        return chunk;
+    }
+#endif
+    for (unsigned i = 0; i < chunk.length; ++i) {
+        chunk.bytes |= std::uint64_t(static_cast<unsigned char>(s[depth + i])) << (56 - 8 * i);
+    }
+    return chunk;
+}
+
+// three-way radix quicksort (Bentley and Sedgewick) on eight-character
+// chunks: partition into <, = and >, then only the = part moves on to the
+// next chunk, so a shared prefix costs one comparison per eight characters
+inline void multikey_quicksort(std::string_view * a, std::size_t n, std::size_t depth, std::size_t * lcp) {
+    while (n >= 16) {
+        // the median of three chunks is the pivot
+        auto x = chunk_at(a[0], depth), y = chunk_at(a[n / 2], depth), z = chunk_at(a[n - 1], depth);
+        auto pivot = (x < y) ? ((y < z) ? y : ((x < z) ? z : x)) : ((x < z) ? x : ((y < z) ? z : y));
+
+        // [0, less) < pivot, [less, i) == pivot, [greater, n) > pivot
+        std::size_t less = 0, i = 0, greater = n;
+        while (i < greater) {
+            auto c = chunk_at(a[i], depth);
+            if (c < pivot) std::swap(a[less++], a[i++]);
+            else if (pivot < c) std::swap(a[i], a[--greater]);
+            else ++i;
+        }
+        // one chunk shared by the whole range: a common prefix, walk it without recursing
+        if (less == 0 && greater == n && pivot.length == 8) {
+            depth += 8;
+            continue;
+        }
+
+        multikey_quicksort(a, less, depth, lcp);
+        if (pivot.length == 8) multikey_quicksort(a + less, greater - less, depth + 8, (lcp) ? lcp + less : nullptr);
+        else if (lcp) {
+            // these all ended inside the chunk: identical strings
+            for (auto k = less + 1; k < greater; ++k) lcp[k] = depth + pivot.length;
+        }
+        multikey_quicksort(a + greater, n - greater, depth, (lcp) ? lcp + greater : nullptr);
+        if (lcp) {
+            // neighbours across a boundary differ within this chunk; known
+            // only once both sides are sorted
+            if (less > 0 && less < n) lcp[less] = depth + common_prefix(a[less - 1], a[less], depth);
+            if (greater > 0 && greater < n) lcp[greater] = depth + common_prefix(a[greater - 1], a[greater], depth);
+        }
+        return;
+    }
+    insertionsort(a, n, depth, lcp);
+}
+
+// most significant character first, 256 buckets plus one for the strings that
+// end at depth. the character of each string at depth is read once into
+// `cache`, and counting and distribution both work from that copy rather than
+// going back to the strings; small buckets go to multikey_quicksort
+inline void msd_radixsort(std::string_view * a, std::size_t n, std::size_t depth, std::size_t * lcp,
+                          std::string_view * temp, std::uint16_t * cache) {
+    while (n >= 4096) {
+        std::size_t counts[257] = {};
+        for (std::size_t i = 0; i < n; ++i) {
+            cache[i] = std::uint16_t(char_at(a[i], depth) + 1);
+            ++counts[cache[i]];
+        }
+        // one bucket holds everything: a common prefix, walk it without recursing
+        if (counts[cache[0]] == n && cache[0] != 0) {
+            ++depth;
+            continue;
+        }
+
+        std::size_t starts[257];
+        std::size_t position = 0;
+        for (int b = 0; b < 257; ++b) {
+            starts[b] = position;
+            position += counts[b];
+        }
+        for (std::size_t i = 0; i < n; ++i) temp[starts[cache[i]]++] = a[i];
+        for (std::size_t i = 0; i < n; ++i) a[i] = temp[i];
+
+        // bucket 0 holds the strings that ended at depth: identical, nothing left to sort
+        if (lcp) {
+            for (std::size_t k = 1; k < counts[0]; ++k) lcp[k] = depth;
+        }
+        // the largest bucket is sorted by this loop rather than by a call,
+        // so each frame on the stack holds at most half of its caller's
+        // strings and the depth stays O(log n) however long the prefixes
+        int largest = 1;
+        for (int b = 2; b < 257; ++b) {
+            if (counts[b] > counts[largest]) largest = b;
+        }
+        std::size_t largest_first = 0;
+        auto next = counts[0];
+        for (int b = 1; b < 257; ++b) {
+            auto first = next;
+            next += counts[b];
+            if (lcp && first > 0 && first < n) lcp[first] = depth;
+            if (b == largest) largest_first = first;
+            else if (counts[b] > 1) msd_radixsort(a + first, counts[b], depth + 1, (lcp) ? lcp + first : nullptr, temp, cache);
+        }
+        if (counts[largest] < 2) return;
+        a += largest_first;
+        if (lcp) lcp += largest_first;
+        n = counts[largest];
+        ++depth;
+    }
+    multikey_quicksort(a, n, depth, lcp);
+}
+
+// merges two sorted runs using their LCP arrays (Ng and Kakehi): each head
+// remembers how much it shares with the last string written, and only a tie
+// there needs characters compared, from that point on
+inline void lcp_merge(const std::string_view * a, const std::size_t * lcp_a, std::size_t na,
+                      const std::string_view * b, const std::size_t * lcp_b, std::size_t nb,
+                      std::string_view * out, std::size_t * lcp_out) {
+    std::size_t i = 0, j = 0, k = 0;
+    std::size_t ha = 0, hb = 0;  // shared with the last string written
+    while (i < na && j < nb) {
+        if (ha > hb) {
+            out[k] = a[i];
+            lcp_out[k++] = ha;
+            ha = (++i < na) ? lcp_a[i] : 0;
+        }
+        else if (ha < hb) {
+            out[k] = b[j];
+            lcp_out[k++] = hb;
+            hb = (++j < nb) ? lcp_b[j] : 0;
+        }
+        else {
+            auto h = ha + common_prefix(a[i], b[j], ha);
+            if (char_at(a[i], h) <= char_at(b[j], h)) {
+                out[k] = a[i];
+                lcp_out[k++] = ha;
+                hb = h;
+                ha = (++i < na) ? lcp_a[i] : 0;
+            }
+            else {
+                out[k] = b[j];
+                lcp_out[k++] = hb;
+                ha = h;
+                hb = (++j < nb) ? lcp_b[j] : 0;
+            }
+        }
+    }
+    for (; i < na; ha = (++i < na) ? lcp_a[i] : 0) {
+        out[k] = a[i];
+        lcp_out[k++] = ha;
+    }
+    for (; j < nb; hb = (++j < nb) ? lcp_b[j] : 0) {
+        out[k] = b[j];
+        lcp_out[k++] = hb;
+    }
+}
+
+// top-down mergesort whose merges are lcp_merge; stable, and the LCP array it
+// needs internally is the one it reports
+inline void lcp_mergesort(std::string_view * a, std::size_t n, std::size_t * lcp, std::string_view * temp, std::size_t * temp_lcp) {
+    if (n < 16) {
+        insertionsort(a, n, 0, lcp);
+        return;
+    }
+    auto mid = n / 2;
+    lcp_mergesort(a, mid, lcp, temp, temp_lcp);
+    lcp_mergesort(a + mid, n - mid, lcp + mid, temp, temp_lcp);
+    lcp_merge(a, lcp, mid, a + mid, lcp + mid, n - mid, temp, temp_lcp);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = temp[i];
+        lcp[i] = temp_lcp[i];
+    }
+}
+
+// whole-vector entry points; pass `lcp` to get the LCP array back
+inline void multikey_quicksort(std::vector<std::string_view> & vec, std::vector<std::size_t> * lcp = nullptr) {
+    if (lcp) lcp->assign(vec.size(), 0);
+    multikey_quicksort(vec.data(), vec.size(), 0, (lcp) ? lcp->data() : nullptr);
+}
+
+inline void msd_radixsort(std::vector<std::string_view> & vec, std::vector<std::size_t> * lcp = nullptr) {
+    if (lcp) lcp->assign(vec.size(), 0);
+    std::vector<std::string_view> temp(vec.size());
+    std::vector<std::uint16_t> cache(vec.size());
+    msd_radixsort(vec.data(), vec.size(), 0, (lcp) ? lcp->data() : nullptr, temp.data(), cache.data());
+}
+
+inline void lcp_mergesort(std::vector<std::string_view> & vec, std::vector<std::size_t> * lcp = nullptr) {
+    std::vector<std::size_t> own;
+    auto & result = (lcp) ? *lcp : own;
+    result.assign(vec.size(), 0);
+    std::vector<std::string_view> temp(vec.size());
+    std::vector<std::size_t> temp_lcp(vec.size());
+    lcp_mergesort(vec.data(), vec.size(), result.data(), temp.data(), temp_lcp.data());
+    if (!result.empty()) result[0] = 0;
+}
+
+#endif
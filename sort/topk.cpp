@@ -0,0 +1,16 @@
+// the k largest numbers on stdin, largest first, in O(k) memory however long the input
+// usage: topk [k]
+#include <iostream>
+#include <cstdlib>
+
+#include "select.h"
+
+int main(int argc, char * argv[]) {
+    std::size_t k = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100;
+    TopK<long long> top(k);
+    long long num;
+    while (std::cin >> num) {
+        top.push(num);
+    }
+    for (auto && i : top.sorted()) { std::cout << i << "\n"; }
+}
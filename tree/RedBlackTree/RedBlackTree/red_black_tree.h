@@ -0,0 +1,801 @@
+#ifndef RED_BLACK_TREE_H
+#define RED_BLACK_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <functional>
+#include <utility>
+#include <type_traits>
+
+#include "../../payload.h"
+#include "../../stats.h"
+
+enum class Colors {
+    red, black
+};
+
+// nodes carry the key only; the payload lives in the tree's value column
+// and is reached through `slot`, so a descent never pulls values into cache
+template <typename Key, typename Data = NoAugment::data>
+struct RBNode : Data {
+    RBNode * left;
+    RBNode * right;
+    Key key;
+    Colors color;
+    std::size_t slot;
+    
+    RBNode() : left(nullptr), right(nullptr), key(), color(Colors::red), slot(0) {}
+    RBNode(Key k, std::size_t s) : left(nullptr), right(nullptr), key(k), color(Colors::red), slot(s) {}
+};
+
+template <typename Key, typename Value = Empty, typename Compare = std::less<Key>, typename Augment = NoAugment>
+class RedBlackTree {
+    using node_type = RBNode<Key, typename Augment::data> *;
+    using size_type = std::size_t;
+    static constexpr bool augmented = !std::is_same<Augment, NoAugment>::value;
+public:
+    node_type root;
+    static enum Children { left, right } children;
+    
+private:
+    Compare comp;
+    std::vector<Value> values;       // out-of-line payloads, indexed by RBNode::slot
+    std::vector<size_type> free_slots;
+    
+    unsigned int max(unsigned lhs, unsigned rhs) { return (lhs > rhs) ? lhs : rhs; }
+    bool less(const Key & lhs, const Key & rhs) const { TreeStats::count(Counters::comparisons); return comp(lhs, rhs); }
+    
+    void set_color(node_type, Colors);
+    Colors get_color(node_type);
+    
+    template <typename... Args> size_type acquire(Args &&... args);
+    void release(size_type slot);
+    
+    void remove(node_type iterator, const Key & key);
+    void insert(node_type & iterator, const Key & key, size_type slot);
+    void destroy(node_type node);
+    void free_subtree(node_type node);
+    unsigned black_height(node_type node);
+    
+    node_type join(node_type left, unsigned left_bh, node_type middle, node_type right, unsigned right_bh, unsigned & bh);
+    node_type join_right(node_type left, unsigned left_bh, node_type middle, node_type right, unsigned right_bh);
+    node_type join_left(node_type left, unsigned left_bh, node_type middle, node_type right, unsigned right_bh);
+    node_type join(node_type left, unsigned left_bh, node_type right, unsigned right_bh);
+    void split(node_type node, unsigned node_bh, const Key & key, bool inclusive, node_type & left, unsigned & left_bh, node_type & right, unsigned & right_bh);
+    void insert_fixup(node_type current, node_type parent);
+    void remove_fixup(node_type current, node_type parent, Children child);
+    void refresh(const Key & key);
+    
+    void preorder_traverse(node_type node) const;
+    void inorder_traverse(node_type node) const;
+    void postorder_traverse(node_type node) const;
+    template <typename Function> void inorder_visit(node_type node, Function & function) const;
+    template <typename Function> bool range_visit(node_type node, const Key & low, const Key & high, Function & function) const;
+    template <typename Iterator> node_type build(Iterator first, size_type low, size_type high, unsigned depth, unsigned levels);
+    
+    auto find(node_type node, const Key & key) const -> decltype(node);
+    auto get_parent(node_type & node, node_type & parent) const -> decltype(node);
+    auto get_link(node_type & node) -> decltype(node);
+    auto get_leftmost_child(node_type node) const -> decltype(node);
+    auto get_rightmost_child(node_type node) const -> decltype(node);
+    
+    auto left_rotate(node_type node) -> decltype(node);
+    auto right_rotate(node_type node) -> decltype(node);
+    
+public:
+    static enum Directions { preorder, inorder, postorder } directions;
+    
+public:
+    RedBlackTree() : root(nullptr) {}
+    explicit RedBlackTree(Compare c) : root(nullptr), comp(c) {}
+    ~RedBlackTree() { destroy(root); }
+    
+    unsigned height() { return height(root); }
+    
+    void create();
+    bool insert(const Key & key) { return try_emplace(key); }
+    bool insert(const Key & key, Value value) { return try_emplace(key, std::move(value)); }
+    template <typename... Args> bool try_emplace(const Key & key, Args &&... args);
+    bool insert_or_assign(const Key & key, Value value);
+    void remove(const Key & key) { remove(root, key); }
+    // removes every key in [low, high]: two splits and a join along the
+    // boundary paths, O(log n) besides freeing the k nodes removed
+    void erase_range(const Key & low, const Key & high);
+    // removes every key below x, one split
+    void truncate_below(const Key & x);
+    void print(enum Directions direction) const;
+    decltype(auto) find(const Key & key) const { return find(root, key); }
+    
+    // pointers into the value column stay valid until the next insertion
+    Value * get(const Key & key);
+    Value & value(node_type node) { return values[node->slot]; }
+    const Value & value(node_type node) const { return values[node->slot]; }
+    
+    size_type size() const { return values.size() - free_slots.size(); }
+    // calls function(key, value) for every entry in key order
+    template <typename Function> void for_each(Function function) const { inorder_visit(root, function); }
+    // calls function(key, value) for the entries with keys in [low, high], in key
+    // order, until a function returning bool returns false
+    template <typename Function> void scan(const Key & low, const Key & high, Function function) const { range_visit(root, low, high, function); }
+    // replaces the contents with sorted, unique (key, value) pairs in O(n), without rotations
+    template <typename Iterator> void bulk_load(Iterator first, Iterator last);
+};
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::set_color(node_type node, Colors color) {
+    if (!node) return;
+    if (node->color != color) TreeStats::count(Counters::recolorings);
+    node->color = color;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+Colors RedBlackTree<Key, Value, Compare, Augment>::get_color(node_type node) {
+    return (node) ? node->color : Colors::black;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename... Args>
+auto RedBlackTree<Key, Value, Compare, Augment>::acquire(Args &&... args) -> size_type {
+    if (free_slots.empty()) {
+        values.emplace_back(std::forward<Args>(args)...);
+        return values.size() - 1;
+    }
+    auto slot = free_slots.back();
+    free_slots.pop_back();
+    values[slot] = Value(std::forward<Args>(args)...);
+    return slot;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::release(size_type slot) {
+    values[slot] = Value(); // drop whatever the payload owns right away
+    free_slots.push_back(slot);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename... Args>
+bool RedBlackTree<Key, Value, Compare, Augment>::try_emplace(const Key & key, Args &&... args) {
+    // an existing key leaves both the tree shape and its payload untouched
+    if (find(root, key)) return false;
+    insert(root, key, acquire(std::forward<Args>(args)...));
+    refresh(key);
+    return true;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+bool RedBlackTree<Key, Value, Compare, Augment>::insert_or_assign(const Key & key, Value value) {
+    // assigning to an existing key only writes its slot, no recoloring or rotation
+    if (auto node = find(root, key)) {
+        values[node->slot] = std::move(value);
+        return false;
+    }
+    insert(root, key, acquire(std::move(value)));
+    refresh(key);
+    return true;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+Value * RedBlackTree<Key, Value, Compare, Augment>::get(const Key & key) {
+    auto node = find(root, key);
+    return (node) ? &values[node->slot] : nullptr;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::find(node_type node, const Key & key) const -> decltype(node) {
+    while (node) {
+        if (less(key, node->key)) node = node->left;
+        else if (less(node->key, key)) node = node->right;
+        else break;
+    }
+    return node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::get_leftmost_child(node_type node) const -> decltype(node) {
+    if (!node->left && !node->right) {
+        return node;
+    }
+    else if (node->left) {
+        return get_leftmost_child(node->left);
+    }
+    else return node;
+    /*
+    else if (node->left && !node->right) {
+        return get_leftmost_child(node->left);
+    }
+    else {
+        return get_leftmost_child(node->left);
+    }
+     */
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment> // a node's left substree's right most child
+auto RedBlackTree<Key, Value, Compare, Augment>::get_rightmost_child(node_type node) const -> decltype(node) {
+    if (!node->left && !node->right) { return node; }
+    else if (node->right) { return get_rightmost_child(node->right); }
+    else return node;
+    /*
+    else if (node->right && !node->left) { return get_rightmost_child(node->right); }
+    else { return get_rightmost_child(node->right); }
+     */
+}
+
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::preorder_traverse(node_type node) const {
+    if (node == nullptr) { return; }
+    std::cout << node->key << " ";
+    preorder_traverse(node->left);
+    preorder_traverse(node->right);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::inorder_traverse(node_type node) const {
+    if (node == nullptr) return;
+    inorder_traverse(node->left);
+    std::cout << node->key << " ";
+    inorder_traverse(node->right);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Function>
+void RedBlackTree<Key, Value, Compare, Augment>::inorder_visit(node_type node, Function & function) const {
+    if (node == nullptr) return;
+    inorder_visit(node->left, function);
+    function(static_cast<const Key &>(node->key), values[node->slot]);
+    inorder_visit(node->right, function);
+}
+
+// inorder_visit that skips the subtrees wholly outside [low, high]; false
+// once the function has asked to stop
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Function>
+bool RedBlackTree<Key, Value, Compare, Augment>::range_visit(node_type node, const Key & low, const Key & high, Function & function) const {
+    while (node) {
+        if (less(node->key, low)) node = node->right;
+        else if (less(high, node->key)) node = node->left;
+        else break;
+    }
+    if (node == nullptr) return true;
+    return range_visit(node->left, low, high, function)
+        && visit_entry(function, static_cast<const Key &>(node->key), values[node->slot])
+        && range_visit(node->right, low, high, function);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::postorder_traverse(node_type node) const {
+    if (node == nullptr) return;
+    postorder_traverse(node->left);
+    postorder_traverse(node->right);
+    std::cout << node->key << " ";
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::destroy(node_type node) {
+    if (node == nullptr) return;
+    if (node == root) {
+        destroy(root->left);
+        destroy(root->right);
+        delete root;
+        root = nullptr;
+        return;
+    }
+    // retrive information
+    auto parent = get_parent(node, root);
+    if (parent != nullptr) {
+        if (parent->left == node) { parent->left = nullptr; }
+        else parent->right = nullptr;
+    }
+    destroy(node->left);
+    destroy(node->right);
+    delete node;
+    return;
+}
+
+// frees a detached subtree and its slots, with no fixups on the way
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::free_subtree(node_type node) {
+    if (node == nullptr) return;
+    free_subtree(node->left);
+    free_subtree(node->right);
+    release(node->slot);
+    delete node;
+}
+
+// black nodes on any path down from node, node included
+template <typename Key, typename Value, typename Compare, typename Augment>
+unsigned RedBlackTree<Key, Value, Compare, Augment>::black_height(node_type node) {
+    unsigned bh = 0;
+    for (; node; node = node->left) bh += (node->color == Colors::black);
+    return bh;
+}
+
+// the tree of left, middle and right, where every key of left is before
+// middle and every key of right after it, given their black heights. the
+// lower tree hangs as a red node from the spine of the other at the first
+// black node of equal black height, and the red-red link that may leave is
+// rotated away on the way back up, as insert_fixup would. the result has a
+// black root, and bh is its black height
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::join(node_type left, unsigned left_bh, node_type middle, node_type right, unsigned right_bh, unsigned & bh) -> node_type {
+    if (get_color(left) == Colors::red) {
+        set_color(left, Colors::black);
+        ++left_bh;
+    }
+    if (get_color(right) == Colors::red) {
+        set_color(right, Colors::black);
+        ++right_bh;
+    }
+    node_type result;
+    if (left_bh > right_bh) {
+        result = join_right(left, left_bh, middle, right, right_bh);
+        bh = left_bh;
+    }
+    else if (right_bh > left_bh) {
+        result = join_left(left, left_bh, middle, right, right_bh);
+        bh = right_bh;
+    }
+    else {
+        middle->left = left;
+        middle->right = right;
+        Augment::update(middle);
+        result = middle;
+        middle->color = Colors::red;  // blackened below
+        bh = left_bh;
+    }
+    if (result->color == Colors::red) {
+        set_color(result, Colors::black);
+        ++bh;
+    }
+    return result;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::join_right(node_type left, unsigned left_bh, node_type middle, node_type right, unsigned right_bh) -> node_type {
+    if (get_color(left) == Colors::black && left_bh == right_bh) {
+        middle->left = left;
+        middle->right = right;
+        middle->color = Colors::red;
+        Augment::update(middle);
+        return middle;
+    }
+    auto child_bh = left_bh - (left->color == Colors::black);
+    left->right = join_right(left->right, child_bh, middle, right, right_bh);
+    if (left->color == Colors::black && get_color(left->right) == Colors::red && get_color(left->right->right) == Colors::red) {
+        set_color(left->right->right, Colors::black);
+        return left_rotate(left);
+    }
+    Augment::update(left);
+    return left;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::join_left(node_type left, unsigned left_bh, node_type middle, node_type right, unsigned right_bh) -> node_type {
+    if (get_color(right) == Colors::black && right_bh == left_bh) {
+        middle->left = left;
+        middle->right = right;
+        middle->color = Colors::red;
+        Augment::update(middle);
+        return middle;
+    }
+    auto child_bh = right_bh - (right->color == Colors::black);
+    right->left = join_left(left, left_bh, middle, right->left, child_bh);
+    if (right->color == Colors::black && get_color(right->left) == Colors::red && get_color(right->left->left) == Colors::red) {
+        set_color(right->left->left, Colors::black);
+        return right_rotate(right);
+    }
+    Augment::update(right);
+    return right;
+}
+
+// the same with no middle node: the smallest key of right is split off to be it
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::join(node_type left, unsigned left_bh, node_type right, unsigned right_bh) -> node_type {
+    if (!right) return left;
+    node_type middle, rest;
+    unsigned middle_bh, rest_bh, bh;
+    split(right, right_bh, get_leftmost_child(right)->key, true, middle, middle_bh, rest, rest_bh);
+    return join(left, left_bh, middle, rest, rest_bh, bh);
+}
+
+// cuts the tree under node, of black height node_bh, into the keys before
+// key (up to and including it if inclusive) and the rest. each node on the
+// search path is joined back to the side it belongs to, and the joins along
+// one side cost a telescoping sum of black height differences, O(log n) in
+// all. the parts come back with their black heights
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::split(node_type node, unsigned node_bh, const Key & key, bool inclusive, node_type & left, unsigned & left_bh, node_type & right, unsigned & right_bh) {
+    if (!node) {
+        left = right = nullptr;
+        left_bh = right_bh = 0;
+        return;
+    }
+    auto lower = node->left, upper = node->right;
+    auto child_bh = node_bh - (node->color == Colors::black);
+    node->left = node->right = nullptr;
+    node_type first, second;
+    unsigned first_bh, second_bh;
+    if (inclusive ? !less(key, node->key) : less(node->key, key)) {
+        split(upper, child_bh, key, inclusive, first, first_bh, second, second_bh);
+        left = join(lower, child_bh, node, first, first_bh, left_bh);
+        right = second;
+        right_bh = second_bh;
+    }
+    else {
+        split(lower, child_bh, key, inclusive, first, first_bh, second, second_bh);
+        left = first;
+        left_bh = first_bh;
+        right = join(second, second_bh, node, upper, child_bh, right_bh);
+    }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::erase_range(const Key & low, const Key & high) {
+    if (less(high, low)) return;
+    node_type below, rest, inside, above;
+    unsigned below_bh, rest_bh, inside_bh, above_bh;
+    split(root, black_height(root), low, false, below, below_bh, rest, rest_bh);
+    split(rest, rest_bh, high, true, inside, inside_bh, above, above_bh);
+    free_subtree(inside);
+    root = join(below, below_bh, above, above_bh);
+    set_color(root, Colors::black);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::truncate_below(const Key & x) {
+    node_type below, rest;
+    unsigned below_bh, rest_bh;
+    split(root, black_height(root), x, false, below, below_bh, rest, rest_bh);
+    free_subtree(below);
+    root = rest;
+    set_color(root, Colors::black);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Iterator>
+void RedBlackTree<Key, Value, Compare, Augment>::bulk_load(Iterator first, Iterator last) {
+    destroy(root);
+    values.clear();
+    free_slots.clear();
+    size_type n = last - first;
+    values.reserve(n);
+    // a tree cut at the midpoints has all its leaves on the last two levels
+    unsigned levels = 0;
+    while ((size_type(1) << levels) - 1 < n) ++levels;
+    root = build(first, 0, n, 1, levels);
+    set_color(root, Colors::black);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Iterator>
+auto RedBlackTree<Key, Value, Compare, Augment>::build(Iterator first, size_type low, size_type high, unsigned depth, unsigned levels) -> node_type {
+    if (low >= high) return nullptr;
+    auto mid = low + (high - low) / 2;
+    // built in order, so the value column ends up in key order as well
+    auto left = build(first, low, mid, depth + 1, levels);
+    auto node = new RBNode<Key, typename Augment::data>(first[mid].first, acquire(first[mid].second));
+    TreeStats::count(Counters::allocations);
+    node->left = left;
+    node->right = build(first, mid + 1, high, depth + 1, levels);
+    Augment::update(node);
+    // only the last level is red, which keeps every path at levels - 1 black nodes
+    node->color = (depth == levels) ? Colors::red : Colors::black;
+    return node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::print(enum Directions direction) const {
+    switch (direction) {
+        case Directions::preorder: {
+            preorder_traverse(root);
+            break;
+        }
+        case Directions::inorder: {
+            inorder_traverse(root);
+            break;
+        }
+        case Directions::postorder: {
+            postorder_traverse(root);
+            break;
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::get_parent(node_type & node, node_type & parent) const -> decltype(node) {
+    if (node == nullptr || parent == nullptr) return parent;
+    TreeStats::count(Counters::get_parent);
+    if (parent->left == node || parent->right == node) {
+        return parent;
+    }
+    // keys are unique, so the path to the parent follows the key
+    else if (less(node->key, parent->key)) {
+        return get_parent(node, parent->left);
+    }
+    else return get_parent(node, parent->right);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment> // the pointer that holds `node`: root or a child field of its parent
+auto RedBlackTree<Key, Value, Compare, Augment>::get_link(node_type & node) -> decltype(node) {
+    auto & parent = get_parent(node, root);
+    if (!parent) return root;
+    return (parent->left == node) ? parent->left : parent->right;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::left_rotate(node_type node) -> decltype(node) {
+    if (!node) return node;
+    TreeStats::count(Counters::rotations);
+    auto right = node->right;
+    node->right = right->left;
+    right->left = node;
+    Augment::update(node);
+    Augment::update(right);
+    return right;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto RedBlackTree<Key, Value, Compare, Augment>::right_rotate(node_type node) -> decltype(node) {
+    if (!node) return node;
+    TreeStats::count(Counters::rotations);
+    auto left = node->left;
+    node->left = left->right;
+    left->right = node;
+    Augment::update(node);
+    Augment::update(left);
+    return left;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::insert(node_type & iterator, const Key & key, size_type slot) {
+    if (!iterator) {
+        iterator = new RBNode<Key, typename Augment::data>(key, slot);
+        TreeStats::count(Counters::allocations);
+        auto parent = get_parent(iterator, root);
+        if (parent && get_color(parent) == Colors::red) insert_fixup(iterator, parent);
+        set_color(root, Colors::black);
+    }
+    else if (less(key, iterator->key)) { insert(iterator->left, key, slot); }
+    else { insert(iterator->right, key, slot); }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::insert_fixup(node_type current, node_type parent) {
+    // a red parent is never the root, so the grandparent always exists
+    while (get_color(parent) == Colors::red) {
+        auto & grandparent = get_parent(parent, root);
+        if (parent == grandparent->left) {
+            auto uncle = grandparent->right;
+            // red uncle
+            if (get_color(uncle) == Colors::red) {
+                set_color(parent, Colors::black);
+                set_color(uncle, Colors::black);
+                set_color(grandparent, Colors::red);
+                current = grandparent;
+                parent = get_parent(current, root);
+            }
+            else {
+                // black uncle, triangle
+                if (current == parent->right) {
+                    grandparent->left = left_rotate(parent);
+                    current = parent;
+                    parent = grandparent->left;
+                }
+                // black uncle, line
+                // switching color of parent and grandparent
+                set_color(parent, Colors::black);
+                set_color(grandparent, Colors::red);
+                grandparent = right_rotate(grandparent);
+                break;
+            }
+        }
+        else { // parent == grandparent->right
+            auto uncle = grandparent->left;
+            if (get_color(uncle) == Colors::red) {
+                set_color(parent, Colors::black);
+                set_color(uncle, Colors::black);
+                set_color(grandparent, Colors::red);
+                current = grandparent;
+                parent = get_parent(current, root);
+            }
+            else {
+                if (current == parent->left) {
+                    grandparent->right = right_rotate(parent);
+                    current = parent;
+                    parent = grandparent->right;
+                }
+                set_color(parent, Colors::black);
+                set_color(grandparent, Colors::red);
+                grandparent = left_rotate(grandparent);
+                break;
+            }
+        }
+    }
+    set_color(root, Colors::black);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::remove(node_type iterator, const Key & key) {
+    if (!iterator) return;
+    if (less(key, iterator->key)) {
+        remove(iterator->left, key);
+    }
+    else if (less(iterator->key, key)) {
+        remove(iterator->right, key);
+    }
+    else {
+        if (iterator->left && iterator->right) {
+            // the predecessor's slot travels with its key, and the slot being
+            // removed goes down with the predecessor node to be released there;
+            // the key is copied last so get_parent can still follow it down
+            auto predecessor = get_rightmost_child(iterator->left);
+            auto moved = predecessor->key;
+            std::swap(iterator->slot, predecessor->slot);
+            TreeStats::count(Counters::swaps);
+            remove(iterator->left, moved);
+            iterator->key = moved;
+            refresh(moved);
+        }
+        else if (!iterator->left && !iterator->right) {
+            auto parent = get_parent(iterator, root);
+            Children child = Children::left;
+            if (!parent) { root = nullptr; }
+            else if (iterator == parent->left) {
+                parent->left = nullptr;
+                child = Children::left;
+            }
+            else {
+                parent->right = nullptr;
+                child = Children::right;
+            }
+            if (parent && iterator->color == Colors::black) remove_fixup(nullptr, parent, child);
+            release(iterator->slot);
+            delete iterator;
+            refresh(key);
+        }
+        else if (iterator->left) {
+            // a lone child is always a red leaf under a black node
+            get_link(iterator) = iterator->left;
+            set_color(iterator->left, Colors::black);
+            release(iterator->slot);
+            delete iterator;
+            refresh(key);
+        }
+        else {
+            get_link(iterator) = iterator->right;
+            set_color(iterator->right, Colors::black);
+            release(iterator->slot);
+            delete iterator;
+            refresh(key);
+        }
+    }
+}
+
+// the nodes whose subtree gained or lost an entry are exactly the ones on
+// the path to the gap just below `key`; recompute them lowest first
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::refresh(const Key & key) {
+    if (!augmented) return;
+    node_type path[128];  // a red-black tree is at most 2 log2(n + 1) deep
+    int depth = 0;
+    for (auto node = root; node; node = (less(node->key, key)) ? node->right : node->left) {
+        path[depth++] = node;
+    }
+    while (depth > 0) Augment::update(path[--depth]);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void RedBlackTree<Key, Value, Compare, Augment>::remove_fixup(node_type current, node_type parent, Children child) {
+    // `current` may be null, so `child` says which side of `parent` it hangs on
+    while (get_color(current) == Colors::black && current != root) {
+        // left child
+        if (child == Children::left) {
+            auto sibling = parent->right;
+            
+            // case2: left child, red sibling
+            if (get_color(sibling) == Colors::red) {
+                set_color(sibling, Colors::black);
+                set_color(parent, Colors::red);
+                
+                auto & link = get_link(parent);
+                link = left_rotate(parent);
+                sibling = parent->right;
+            }
+
+            // case3: left child, black sibling, 2 black nephews
+            if (get_color(sibling->left) == Colors::black && get_color(sibling->right) == Colors::black) {
+                set_color(sibling, Colors::red);
+                
+                // case4: left child, black sibling, red parent, terminal case
+                if (get_color(parent) == Colors::red) {
+                    set_color(parent, Colors::black);
+                    return;
+                }
+                current = parent;
+                parent = get_parent(current, root);
+                if (parent) child = (parent->left == current) ? Children::left : Children::right;
+                continue;
+            }
+            
+            // case5: left child, black sibling, right nephew black
+            if (get_color(sibling->right) == Colors::black) {
+                set_color(sibling->left, Colors::black);
+                set_color(sibling, Colors::red);
+                
+                parent->right = right_rotate(sibling);
+                sibling = parent->right;
+            }
+            // case6: left child, black sibling, right nephew red, terminal case
+            set_color(sibling, parent->color);
+            set_color(parent, Colors::black);
+            set_color(sibling->right, Colors::black);
+            
+            auto & link = get_link(parent);
+            link = left_rotate(parent);
+            break;
+        }
+        // right child
+        else {
+            auto sibling = parent->left;
+            
+            // case2: right child, left sibling red
+            if (get_color(sibling) == Colors::red) {
+                set_color(sibling, Colors::black);
+                set_color(parent, Colors::red);
+                
+                auto & link = get_link(parent);
+                link = right_rotate(parent);
+                sibling = parent->left;
+            }
+            
+            // case3: right child, left sibling black, 2 black nieces
+            if (get_color(sibling->left) == Colors::black && get_color(sibling->right) == Colors::black) {
+                set_color(sibling, Colors::red);
+                
+                // case4: right child, black sibling, red parent
+                if (get_color(parent) == Colors::red) {
+                    set_color(parent, Colors::black);
+                    return;
+                }
+                current = parent;
+                parent = get_parent(current, root);
+                if (parent) child = (parent->left == current) ? Children::left : Children::right;
+                continue;
+            }
+            
+            // case5: right child, left sibling black, left black nephew
+            if (get_color(sibling->left) == Colors::black) {
+                set_color(sibling->right, Colors::black);
+                set_color(sibling, Colors::red);
+                
+                parent->left = left_rotate(sibling);
+                sibling = parent->left;
+            }
+            
+            // case6: right child, left sibling black, left nephew red, terminal case
+            set_color(sibling, parent->color);
+            set_color(parent, Colors::black);
+            set_color(sibling->left, Colors::black);
+            
+            auto & link = get_link(parent);
+            link = right_rotate(parent);
+            break;
+        }
+    }
+    // case 1: double black is root
+    set_color(root, Colors::black);
+}
+
+#endif
@@ -0,0 +1,28 @@
+#include <limits>
+
+#include "adaptive_radix_tree.h"
+
+int main() {
+    AdaptiveRadixTree<long long> tree;
+    tree.create();
+    tree.for_each([](long long key, const Empty &) { std::cout << key << " "; });
+    std::cout << std::endl;
+
+    long long temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    std::cout << (tree.find(temp) ? "found" : "not found") << std::endl;
+
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    tree.remove(temp);
+
+    tree.scan(std::numeric_limits<long long>::min(), 999, [](long long key, const Empty &) { std::cout << key << " "; });
+    std::cout << std::endl;
+
+    // byte-string keys, in byte order
+    AdaptiveRadixTree<std::string, int> words;
+    for (std::string word : { "radix", "tree", "rad", "radar", "trie", "r" }) words.insert(word, int(word.size()));
+    words.for_each([](const std::string & word, int length) { std::cout << word << ":" << length << " "; });
+    std::cout << std::endl << words.memory() << " bytes in nodes and leaves" << std::endl;
+}
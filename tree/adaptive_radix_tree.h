@@ -0,0 +1,663 @@
+#ifndef ADAPTIVE_RADIX_TREE_H
+#define ADAPTIVE_RADIX_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <functional>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "payload.h"
+#include "stats.h"
+
+// how a key is read as a string of bytes whose order is the key order.
+// integers are big-endian with the sign bit flipped, so negatives come
+// first; strings are their bytes and a 0 terminator, which keeps every key
+// from being a prefix of another and sorts "ab" before "abc"
+template <typename Key, typename = void>
+struct RadixKey;
+
+template <typename Key>
+struct RadixKey<Key, typename std::enable_if<std::is_integral<Key>::value>::type> {
+    using U = typename std::make_unsigned<Key>::type;
+    static constexpr U flip = std::is_signed<Key>::value ? U(U(1) << (sizeof(Key) * 8 - 1)) : U(0);
+
+    static void check(const Key &) {}
+    static std::uint8_t byte(const Key & key, std::size_t i) {
+        return (i < sizeof(Key)) ? std::uint8_t((U(key) ^ flip) >> (8 * (sizeof(Key) - 1 - i))) : 0;
+    }
+};
+
+template <>
+struct RadixKey<std::string> {
+    static void check(const std::string & key) {
+        if (key.find('\0') != std::string::npos) throw std::runtime_error("radix tree string keys cannot hold a 0 byte");
+    }
+    static std::uint8_t byte(const std::string & key, std::size_t i) {
+        return (i < key.size()) ? std::uint8_t(key[i]) : 0;
+    }
+};
+
+// an ordered map that branches on one byte of the key per level instead of
+// comparing keys (Leis et al., "The Adaptive Radix Tree"). a lookup costs at
+// most one step per key byte, 8 for a 64-bit integer whatever n is, where a
+// balanced tree takes about log2 n comparisons, each a cache miss
+//
+// inner nodes come in four sizes and grow or shrink with their fan-out:
+// Node4 and Node16 hold sorted key bytes beside their children, Node16
+// searched with one SSE2 compare; Node48 maps all 256 bytes to 48 child
+// slots; Node256 is a plain array. a sparse level thus costs a few bytes
+// and a dense one 8 bytes per child, with no per-node key or balance data
+//
+// two things keep the tree short. path compression: a node stores the bytes
+// its only path shares below its parent (the first max_prefix of them; the
+// rest are checked at the leaf), so chains of one-child nodes never exist.
+// lazy expansion: a key alone in its subtree is a leaf right where it
+// branched off, however many bytes are left. either way the leaf holds the
+// whole key, and a lookup ends by comparing it once
+template <typename Key, typename Value = Empty>
+class AdaptiveRadixTree {
+    using Bytes = RadixKey<Key>;
+    static constexpr unsigned max_prefix = 8;
+
+    enum class Type : std::uint8_t { node4, node16, node48, node256 };
+
+    struct Node {
+        Type type;
+        std::uint16_t count;
+        std::uint32_t prefix_length;
+        std::uint8_t prefix[max_prefix];
+
+        explicit Node(Type t) : type(t), count(0), prefix_length(0) {}
+    };
+    struct Node4 : Node {
+        std::uint8_t keys[4];
+        Node * children[4];
+        Node4() : Node(Type::node4) {}
+    };
+    struct Node16 : Node {
+        std::uint8_t keys[16];
+        Node * children[16];
+        Node16() : Node(Type::node16) {}
+    };
+    struct Node48 : Node {
+        std::uint8_t index[256];  // child slot + 1, or 0 for none
+        Node * children[48];
+        Node48() : Node(Type::node48) {
+            std::memset(index, 0, sizeof(index));
+            std::memset(children, 0, sizeof(children));
+        }
+    };
+    struct Node256 : Node {
+        Node * children[256];
+        Node256() : Node(Type::node256) { std::memset(children, 0, sizeof(children)); }
+    };
+    struct Leaf {
+        Key key;
+        Value value;
+    };
+
+    // a child with its low bit set is a Leaf
+    static bool is_leaf(const Node * node) { return reinterpret_cast<std::uintptr_t>(node) & 1; }
+    static Leaf * as_leaf(const Node * node) { return reinterpret_cast<Leaf *>(reinterpret_cast<std::uintptr_t>(node) & ~std::uintptr_t(1)); }
+    static Node * tag(Leaf * leaf) { return reinterpret_cast<Node *>(reinterpret_cast<std::uintptr_t>(leaf) | 1); }
+
+    Node * root;
+    std::size_t entries;
+    std::size_t bytes;  // held by nodes and leaves
+
+    bool matches(const Leaf * leaf, const Key & key) const { TreeStats::count(Counters::comparisons); return leaf->key == key; }
+    template <typename T> T * allocate();
+    template <typename... Args> Node * make_leaf(const Key & key, Args &&... args);
+    void free_node(Node * node);
+    void destroy(Node * node);
+
+    static Node ** find_child(Node * node, std::uint8_t byte);
+    static Leaf * minimum(Node * node);
+    static std::uint8_t prefix_byte(Node * node, std::size_t depth, std::size_t i);
+    std::size_t prefix_mismatch(Node * node, const Key & key, std::size_t depth) const;
+    void add_child(Node *& ref, std::uint8_t byte, Node * child);
+    void remove_child(Node *& ref, std::uint8_t byte, Node ** slot);
+    template <typename Function> static bool each_child(Node * node, Function function);
+
+    template <typename Function> void inorder_visit(Node * node, Function & function) const;
+    template <typename Function> void range_visit(Node * node, std::size_t depth, bool low_tight, bool high_tight,
+                                                  const Key & low, const Key & high, Function & function) const;
+    Leaf * lookup(const Key & key) const;
+
+    public:
+    AdaptiveRadixTree() : root(nullptr), entries(0), bytes(0) {}
+    ~AdaptiveRadixTree() { destroy(root); }
+    AdaptiveRadixTree(const AdaptiveRadixTree &) = delete;
+    AdaptiveRadixTree & operator=(const AdaptiveRadixTree &) = delete;
+
+    void create();
+    bool insert(const Key & key) { return try_emplace(key); }
+    bool insert(const Key & key, Value value) { return try_emplace(key, std::move(value)); }
+    template <typename... Args> bool try_emplace(const Key & key, Args &&... args);
+    bool insert_or_assign(const Key & key, Value value);
+    bool remove(const Key & key);
+    bool find(const Key & key) const { return lookup(key) != nullptr; }
+    Value * get(const Key & key) { auto leaf = lookup(key); return leaf ? &leaf->value : nullptr; }
+
+    std::size_t size() const { return entries; }
+    // bytes held by nodes and leaves, allocator overhead aside
+    std::size_t memory() const { return bytes; }
+    // calls function(key, value) for every entry in key order
+    template <typename Function> void for_each(Function function) const { inorder_visit(root, function); }
+    // calls function(key, value) for the entries with keys in [low, high], in key order
+    template <typename Function> void scan(const Key & low, const Key & high, Function function) const;
+};
+
+template <typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+template <typename Key, typename Value>
+template <typename T>
+T * AdaptiveRadixTree<Key, Value>::allocate() {
+    TreeStats::count(Counters::allocations);
+    bytes += sizeof(T);
+    return new T();
+}
+
+template <typename Key, typename Value>
+template <typename... Args>
+auto AdaptiveRadixTree<Key, Value>::make_leaf(const Key & key, Args &&... args) -> Node * {
+    TreeStats::count(Counters::allocations);
+    bytes += sizeof(Leaf);
+    return tag(new Leaf{ key, Value(std::forward<Args>(args)...) });
+}
+
+template <typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::free_node(Node * node) {
+    if (is_leaf(node)) {
+        bytes -= sizeof(Leaf);
+        delete as_leaf(node);
+        return;
+    }
+    switch (node->type) {
+        case Type::node4: bytes -= sizeof(Node4); delete static_cast<Node4 *>(node); break;
+        case Type::node16: bytes -= sizeof(Node16); delete static_cast<Node16 *>(node); break;
+        case Type::node48: bytes -= sizeof(Node48); delete static_cast<Node48 *>(node); break;
+        case Type::node256: bytes -= sizeof(Node256); delete static_cast<Node256 *>(node); break;
+    }
+}
+
+template <typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::destroy(Node * node) {
+    if (node == nullptr) return;
+    if (!is_leaf(node)) each_child(node, [this](std::uint8_t, Node * child) { destroy(child); return true; });
+    free_node(node);
+}
+
+// the slot holding the child for byte, or nullptr
+template <typename Key, typename Value>
+auto AdaptiveRadixTree<Key, Value>::find_child(Node * node, std::uint8_t byte) -> Node ** {
+    switch (node->type) {
+        case Type::node4: {
+            auto n = static_cast<Node4 *>(node);
+            for (unsigned i = 0; i < n->count; ++i) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return nullptr;
+        }
+        case Type::node16: {
+            auto n = static_cast<Node16 *>(node);
+#if defined(__SSE2__)
+            // all 16 key bytes against byte at once; the mask drops unused ones
+            auto equal = _mm_cmpeq_epi8(_mm_set1_epi8(char(byte)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys)));
+            unsigned mask = unsigned(_mm_movemask_epi8(equal)) & ((1u << n->count) - 1);
+            return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+            for (unsigned i = 0; i < n->count; ++i) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return nullptr;
+#endif
+        }
+        case Type::node48: {
+            auto n = static_cast<Node48 *>(node);
+            return n->index[byte] ? &n->children[n->index[byte] - 1] : nullptr;
+        }
+        case Type::node256: {
+            auto n = static_cast<Node256 *>(node);
+            return n->children[byte] ? &n->children[byte] : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+// calls function(byte, child) in byte order until it returns false
+template <typename Key, typename Value>
+template <typename Function>
+bool AdaptiveRadixTree<Key, Value>::each_child(Node * node, Function function) {
+    switch (node->type) {
+        case Type::node4: {
+            auto n = static_cast<Node4 *>(node);
+            for (unsigned i = 0; i < n->count; ++i) {
+                if (!function(n->keys[i], n->children[i])) return false;
+            }
+            break;
+        }
+        case Type::node16: {
+            auto n = static_cast<Node16 *>(node);
+            for (unsigned i = 0; i < n->count; ++i) {
+                if (!function(n->keys[i], n->children[i])) return false;
+            }
+            break;
+        }
+        case Type::node48: {
+            auto n = static_cast<Node48 *>(node);
+            for (unsigned b = 0; b < 256; ++b) {
+                if (n->index[b] && !function(std::uint8_t(b), n->children[n->index[b] - 1])) return false;
+            }
+            break;
+        }
+        case Type::node256: {
+            auto n = static_cast<Node256 *>(node);
+            for (unsigned b = 0; b < 256; ++b) {
+                if (n->children[b] && !function(std::uint8_t(b), n->children[b])) return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+template <typename Key, typename Value>
+auto AdaptiveRadixTree<Key, Value>::minimum(Node * node) -> Leaf * {
+    while (!is_leaf(node)) {
+        Node * first = nullptr;
+        each_child(node, [&](std::uint8_t, Node * child) { first = child; return false; });
+        node = first;
+    }
+    return as_leaf(node);
+}
+
+// byte i of the prefix of node, which starts at depth; past the stored
+// bytes it is read from a leaf below, which shares the whole prefix
+template <typename Key, typename Value>
+std::uint8_t AdaptiveRadixTree<Key, Value>::prefix_byte(Node * node, std::size_t depth, std::size_t i) {
+    if (i < max_prefix) return node->prefix[i];
+    return Bytes::byte(minimum(node)->key, depth + i);
+}
+
+// how many bytes of the prefix of node key shares, node->prefix_length if all
+template <typename Key, typename Value>
+std::size_t AdaptiveRadixTree<Key, Value>::prefix_mismatch(Node * node, const Key & key, std::size_t depth) const {
+    std::size_t stored = (node->prefix_length < max_prefix) ? node->prefix_length : max_prefix;
+    for (std::size_t i = 0; i < stored; ++i) {
+        if (node->prefix[i] != Bytes::byte(key, depth + i)) return i;
+    }
+    if (node->prefix_length > max_prefix) {
+        auto leaf = minimum(node);
+        for (std::size_t i = max_prefix; i < node->prefix_length; ++i) {
+            if (Bytes::byte(leaf->key, depth + i) != Bytes::byte(key, depth + i)) return i;
+        }
+    }
+    return node->prefix_length;
+}
+
+// adds child under byte, first moving a full node into the next size up;
+// ref is the slot that points to the node
+template <typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::add_child(Node *& ref, std::uint8_t byte, Node * child) {
+    auto node = ref;
+    auto copy_header = [](Node * to, const Node * from) {
+        to->count = from->count;
+        to->prefix_length = from->prefix_length;
+        std::memcpy(to->prefix, from->prefix, max_prefix);
+    };
+    switch (node->type) {
+        case Type::node4: {
+            auto n = static_cast<Node4 *>(node);
+            if (n->count < 4) {
+                unsigned i = 0;
+                while (i < n->count && n->keys[i] < byte) ++i;
+                std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+                std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(Node *));
+                n->keys[i] = byte;
+                n->children[i] = child;
+                ++n->count;
+                return;
+            }
+            auto grown = allocate<Node16>();
+            copy_header(grown, n);
+            std::memcpy(grown->keys, n->keys, 4);
+            std::memcpy(grown->children, n->children, 4 * sizeof(Node *));
+            free_node(n);
+            ref = grown;
+            return add_child(ref, byte, child);
+        }
+        case Type::node16: {
+            auto n = static_cast<Node16 *>(node);
+            if (n->count < 16) {
+                unsigned i = 0;
+                while (i < n->count && n->keys[i] < byte) ++i;
+                std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+                std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(Node *));
+                n->keys[i] = byte;
+                n->children[i] = child;
+                ++n->count;
+                return;
+            }
+            auto grown = allocate<Node48>();
+            copy_header(grown, n);
+            for (unsigned i = 0; i < 16; ++i) {
+                grown->index[n->keys[i]] = std::uint8_t(i + 1);
+                grown->children[i] = n->children[i];
+            }
+            free_node(n);
+            ref = grown;
+            return add_child(ref, byte, child);
+        }
+        case Type::node48: {
+            auto n = static_cast<Node48 *>(node);
+            if (n->count < 48) {
+                unsigned slot = 0;
+                while (n->children[slot]) ++slot;
+                n->children[slot] = child;
+                n->index[byte] = std::uint8_t(slot + 1);
+                ++n->count;
+                return;
+            }
+            auto grown = allocate<Node256>();
+            copy_header(grown, n);
+            for (unsigned b = 0; b < 256; ++b) {
+                if (n->index[b]) grown->children[b] = n->children[n->index[b] - 1];
+            }
+            free_node(n);
+            ref = grown;
+            return add_child(ref, byte, child);
+        }
+        case Type::node256: {
+            auto n = static_cast<Node256 *>(node);
+            n->children[byte] = child;
+            ++n->count;
+            return;
+        }
+    }
+}
+
+// takes out the child in slot, under byte, then moves the node into the next
+// size down once it is well below its own (not at the boundary, so a key
+// going in and out does not resize every time), or replaces a Node4 left
+// with one child by that child, its prefix lengthened by the node's
+template <typename Key, typename Value>
+void AdaptiveRadixTree<Key, Value>::remove_child(Node *& ref, std::uint8_t byte, Node ** slot) {
+    auto node = ref;
+    auto copy_header = [](Node * to, const Node * from) {
+        to->count = from->count;
+        to->prefix_length = from->prefix_length;
+        std::memcpy(to->prefix, from->prefix, max_prefix);
+    };
+    switch (node->type) {
+        case Type::node4: {
+            auto n = static_cast<Node4 *>(node);
+            auto i = unsigned(slot - n->children);
+            std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+            std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(Node *));
+            if (--n->count > 1) return;
+            auto child = n->children[0];
+            if (!is_leaf(child)) {
+                std::uint8_t merged[max_prefix];
+                std::size_t length = 0;
+                for (std::size_t i = 0; i < n->prefix_length && length < max_prefix; ++i) merged[length++] = n->prefix[i];
+                if (length < max_prefix) merged[length++] = n->keys[0];
+                for (std::size_t i = 0; i < child->prefix_length && length < max_prefix; ++i) merged[length++] = child->prefix[i];
+                std::memcpy(child->prefix, merged, length);
+                child->prefix_length += n->prefix_length + 1;
+            }
+            free_node(n);
+            ref = child;
+            return;
+        }
+        case Type::node16: {
+            auto n = static_cast<Node16 *>(node);
+            auto i = unsigned(slot - n->children);
+            std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+            std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(Node *));
+            if (--n->count > 3) return;
+            auto shrunk = allocate<Node4>();
+            copy_header(shrunk, n);
+            std::memcpy(shrunk->keys, n->keys, n->count);
+            std::memcpy(shrunk->children, n->children, n->count * sizeof(Node *));
+            free_node(n);
+            ref = shrunk;
+            return;
+        }
+        case Type::node48: {
+            auto n = static_cast<Node48 *>(node);
+            *slot = nullptr;
+            n->index[byte] = 0;
+            if (--n->count > 12) return;
+            auto shrunk = allocate<Node16>();
+            copy_header(shrunk, n);
+            unsigned i = 0;
+            for (unsigned b = 0; b < 256; ++b) {
+                if (!n->index[b]) continue;
+                shrunk->keys[i] = std::uint8_t(b);
+                shrunk->children[i++] = n->children[n->index[b] - 1];
+            }
+            free_node(n);
+            ref = shrunk;
+            return;
+        }
+        case Type::node256: {
+            auto n = static_cast<Node256 *>(node);
+            *slot = nullptr;
+            if (--n->count > 37) return;
+            auto shrunk = allocate<Node48>();
+            copy_header(shrunk, n);
+            unsigned i = 0;
+            for (unsigned b = 0; b < 256; ++b) {
+                if (!n->children[b]) continue;
+                shrunk->index[b] = std::uint8_t(i + 1);
+                shrunk->children[i++] = n->children[b];
+            }
+            free_node(n);
+            ref = shrunk;
+            return;
+        }
+    }
+}
+
+// the stored prefix bytes are checked on the way down and the rest are
+// skipped: the leaf at the end has the whole key to compare
+template <typename Key, typename Value>
+auto AdaptiveRadixTree<Key, Value>::lookup(const Key & key) const -> Leaf * {
+    auto node = root;
+    std::size_t depth = 0;
+    while (node) {
+        if (is_leaf(node)) {
+            auto leaf = as_leaf(node);
+            return matches(leaf, key) ? leaf : nullptr;
+        }
+        if (node->prefix_length) {
+            std::size_t stored = (node->prefix_length < max_prefix) ? node->prefix_length : max_prefix;
+            for (std::size_t i = 0; i < stored; ++i) {
+                if (node->prefix[i] != Bytes::byte(key, depth + i)) return nullptr;
+            }
+            depth += node->prefix_length;
+        }
+        auto child = find_child(node, Bytes::byte(key, depth));
+        if (!child) return nullptr;
+        node = *child;
+        ++depth;
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Value>
+template <typename... Args>
+bool AdaptiveRadixTree<Key, Value>::try_emplace(const Key & key, Args &&... args) {
+    Bytes::check(key);
+    auto ref = &root;
+    std::size_t depth = 0;
+    while (true) {
+        auto node = *ref;
+        if (!node) {
+            *ref = make_leaf(key, std::forward<Args>(args)...);
+            ++entries;
+            return true;
+        }
+        if (is_leaf(node)) {
+            auto leaf = as_leaf(node);
+            if (matches(leaf, key)) return false;
+            // the lazy leaf and the new key part where their bytes first differ
+            std::size_t common = 0;
+            while (Bytes::byte(leaf->key, depth + common) == Bytes::byte(key, depth + common)) ++common;
+            Node * split = allocate<Node4>();
+            split->prefix_length = std::uint32_t(common);
+            for (std::size_t i = 0; i < common && i < max_prefix; ++i) split->prefix[i] = Bytes::byte(key, depth + i);
+            add_child(split, Bytes::byte(leaf->key, depth + common), node);
+            add_child(split, Bytes::byte(key, depth + common), make_leaf(key, std::forward<Args>(args)...));
+            *ref = split;
+            ++entries;
+            return true;
+        }
+        if (node->prefix_length) {
+            auto common = prefix_mismatch(node, key, depth);
+            if (common < node->prefix_length) {
+                // a new node takes the shared part; node keeps what follows the byte that differs
+                Node * split = allocate<Node4>();
+                split->prefix_length = std::uint32_t(common);
+                std::memcpy(split->prefix, node->prefix, (common < max_prefix) ? common : max_prefix);
+                auto old_byte = prefix_byte(node, depth, common);
+                auto rest = node->prefix_length - common - 1;
+                if (node->prefix_length <= max_prefix) {
+                    std::memmove(node->prefix, node->prefix + common + 1, rest);
+                }
+                else {
+                    auto leaf = minimum(node);
+                    for (std::size_t i = 0; i < rest && i < max_prefix; ++i) node->prefix[i] = Bytes::byte(leaf->key, depth + common + 1 + i);
+                }
+                node->prefix_length = std::uint32_t(rest);
+                add_child(split, old_byte, node);
+                add_child(split, Bytes::byte(key, depth + common), make_leaf(key, std::forward<Args>(args)...));
+                *ref = split;
+                ++entries;
+                return true;
+            }
+            depth += node->prefix_length;
+        }
+        auto byte = Bytes::byte(key, depth);
+        auto child = find_child(node, byte);
+        if (!child) {
+            add_child(*ref, byte, make_leaf(key, std::forward<Args>(args)...));
+            ++entries;
+            return true;
+        }
+        ref = child;
+        ++depth;
+    }
+}
+
+template <typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::insert_or_assign(const Key & key, Value value) {
+    if (auto leaf = lookup(key)) {
+        leaf->value = std::move(value);
+        return false;
+    }
+    return try_emplace(key, std::move(value));
+}
+
+template <typename Key, typename Value>
+bool AdaptiveRadixTree<Key, Value>::remove(const Key & key) {
+    auto ref = &root;
+    Node ** parent = nullptr;
+    std::uint8_t parent_byte = 0;
+    std::size_t depth = 0;
+    while (true) {
+        auto node = *ref;
+        if (!node) return false;
+        if (is_leaf(node)) {
+            if (!matches(as_leaf(node), key)) return false;
+            if (parent) remove_child(*parent, parent_byte, ref);
+            else root = nullptr;
+            free_node(node);
+            --entries;
+            return true;
+        }
+        if (node->prefix_length) {
+            if (prefix_mismatch(node, key, depth) < node->prefix_length) return false;
+            depth += node->prefix_length;
+        }
+        parent_byte = Bytes::byte(key, depth);
+        auto child = find_child(node, parent_byte);
+        if (!child) return false;
+        parent = ref;
+        ref = child;
+        ++depth;
+    }
+}
+
+template <typename Key, typename Value>
+template <typename Function>
+void AdaptiveRadixTree<Key, Value>::inorder_visit(Node * node, Function & function) const {
+    if (node == nullptr) return;
+    if (is_leaf(node)) {
+        auto leaf = as_leaf(node);
+        function(static_cast<const Key &>(leaf->key), leaf->value);
+        return;
+    }
+    each_child(node, [&](std::uint8_t, Node * child) { inorder_visit(child, function); return true; });
+}
+
+// low_tight and high_tight say whether the path so far equals the bounds'
+// bytes; a subtree that already went past one of them is taken whole on that side
+template <typename Key, typename Value>
+template <typename Function>
+void AdaptiveRadixTree<Key, Value>::range_visit(Node * node, std::size_t depth, bool low_tight, bool high_tight,
+                                                 const Key & low, const Key & high, Function & function) const {
+    if (is_leaf(node)) {
+        auto leaf = as_leaf(node);
+        TreeStats::count(Counters::comparisons);
+        if (!(leaf->key < low) && !(high < leaf->key)) function(static_cast<const Key &>(leaf->key), leaf->value);
+        return;
+    }
+    for (std::size_t i = 0; i < node->prefix_length && (low_tight || high_tight); ++i) {
+        auto byte = prefix_byte(node, depth, i);
+        if (low_tight) {
+            auto bound = Bytes::byte(low, depth + i);
+            if (byte < bound) return;
+            low_tight = (byte == bound);
+        }
+        if (high_tight) {
+            auto bound = Bytes::byte(high, depth + i);
+            if (byte > bound) return;
+            high_tight = (byte == bound);
+        }
+    }
+    depth += node->prefix_length;
+    auto low_byte = Bytes::byte(low, depth), high_byte = Bytes::byte(high, depth);
+    each_child(node, [&](std::uint8_t byte, Node * child) {
+        if (low_tight && byte < low_byte) return true;
+        if (high_tight && byte > high_byte) return false;
+        range_visit(child, depth + 1, low_tight && byte == low_byte, high_tight && byte == high_byte, low, high, function);
+        return true;
+    });
+}
+
+template <typename Key, typename Value>
+template <typename Function>
+void AdaptiveRadixTree<Key, Value>::scan(const Key & low, const Key & high, Function function) const {
+    if (root == nullptr || high < low) return;
+    range_visit(root, 0, true, true, low, high, function);
+}
+
+#endif
@@ -0,0 +1,567 @@
+#ifndef AVL_TREE_H
+#define AVL_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <functional>
+#include <utility>
+
+#include "payload.h"
+#include "stats.h"
+
+// nodes carry the key only; the payload lives in the tree's value column
+// and is reached through `slot`, so a descent never pulls values into cache
+template <typename Key, typename Data = NoAugment::data>
+struct AVLNode : Data {
+    AVLNode * left;
+    AVLNode * right;
+    Key key;
+    unsigned height;
+    std::size_t slot;
+
+    AVLNode(): left(nullptr), right(nullptr), key(), height(0), slot(0) {}
+    AVLNode(Key k, std::size_t s): left(nullptr), right(nullptr), key(k), height(0), slot(s) {}
+};
+
+template <typename Key, typename Value = Empty, typename Compare = std::less<Key>, typename Augment = NoAugment>
+class AVLTree {
+    using node_type = AVLNode<Key, typename Augment::data> *;
+    using size_type = std::size_t;
+    public:
+    node_type root;
+
+    private:
+    Compare comp;
+    std::vector<Value> values;       // out-of-line payloads, indexed by AVLNode::slot
+    std::vector<size_type> free_slots;
+
+    unsigned int height(node_type node) { return (node) ? node->height : 0; }
+    unsigned int max(unsigned lhs, unsigned rhs) { return (lhs > rhs) ? lhs : rhs; }
+    bool less(const Key & lhs, const Key & rhs) const { TreeStats::count(Counters::comparisons); return comp(lhs, rhs); }
+
+    template <typename... Args> size_type acquire(Args &&... args);
+    void release(size_type slot);
+
+    auto insert(node_type & iterator, const Key & key, size_type slot) -> decltype(iterator);
+    auto remove(node_type & iterator, const Key & key) -> decltype(iterator);
+    void destroy(node_type node);
+    void rotate(node_type node);
+    void free_subtree(node_type node);
+    // the height and the augmentation of node, from its children's
+    void update(node_type node) {
+        node->height = max(height(node->left), height(node->right)) + 1;
+        Augment::update(node);
+    }
+
+    node_type join(node_type left, node_type middle, node_type right);
+    node_type join_right(node_type left, node_type middle, node_type right);
+    node_type join_left(node_type left, node_type middle, node_type right);
+    node_type join(node_type left, node_type right);
+    void split(node_type node, const Key & key, bool inclusive, node_type & left, node_type & right);
+    template <typename Iterator> node_type build(Iterator first, size_type low, size_type high);
+
+    void preorder_traverse(node_type node) const;
+    void inorder_traverse(node_type node) const;
+    void postorder_traverse(node_type node) const;
+    template <typename Function> void inorder_visit(node_type node, Function & function) const;
+    template <typename Function> bool range_visit(node_type node, const Key & low, const Key & high, Function & function) const;
+
+    decltype(auto) find(node_type node, const Key & key) const;
+    decltype(auto) get_parent(node_type node, node_type parent) const;
+    decltype(auto) get_leftmost_child(node_type node) const;
+    decltype(auto) get_rightmost_child(node_type node) const;
+
+    decltype(auto) left_rotate(node_type node);
+    decltype(auto) right_rotate(node_type node);
+    decltype(auto) left_right_rotate(node_type node);
+    decltype(auto) right_left_rotate(node_type node);
+
+    public:
+    static enum Directions { preorder, inorder, postorder } directions;
+
+    public:
+    AVLTree(): root(nullptr) {}
+    explicit AVLTree(Compare c): root(nullptr), comp(c) {}
+    ~AVLTree() { destroy(root); }
+
+    unsigned height() { return height(root); }
+
+    void create();
+    bool insert(const Key & key) { return try_emplace(key); }
+    bool insert(const Key & key, Value value) { return try_emplace(key, std::move(value)); }
+    template <typename... Args> bool try_emplace(const Key & key, Args &&... args);
+    bool insert_or_assign(const Key & key, Value value);
+    void remove(const Key & key) { remove(root, key); }
+    // removes every key in [low, high]: two splits and a join along the
+    // boundary paths, O(log n) besides freeing the k nodes removed
+    void erase_range(const Key & low, const Key & high);
+    // removes every key below x, one split
+    void truncate_below(const Key & x);
+    void print(enum Directions direction) const;
+    decltype(auto) find(const Key & key) const { return find(root, key); }
+
+    // pointers into the value column stay valid until the next insertion
+    Value * get(const Key & key);
+    Value & value(node_type node) { return values[node->slot]; }
+    const Value & value(node_type node) const { return values[node->slot]; }
+
+    size_type size() const { return values.size() - free_slots.size(); }
+    // calls function(key, value) for every entry in key order
+    template <typename Function> void for_each(Function function) const { inorder_visit(root, function); }
+    // calls function(key, value) for the entries with keys in [low, high], in key
+    // order, until a function returning bool returns false
+    template <typename Function> void scan(const Key & low, const Key & high, Function function) const { range_visit(root, low, high, function); }
+    // replaces the contents with sorted, unique (key, value) pairs in O(n), without rotations
+    template <typename Iterator> void bulk_load(Iterator first, Iterator last);
+};
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename... Args>
+auto AVLTree<Key, Value, Compare, Augment>::acquire(Args &&... args) -> size_type {
+    if (free_slots.empty()) {
+        values.emplace_back(std::forward<Args>(args)...);
+        return values.size() - 1;
+    }
+    auto slot = free_slots.back();
+    free_slots.pop_back();
+    values[slot] = Value(std::forward<Args>(args)...);
+    return slot;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::release(size_type slot) {
+    values[slot] = Value(); // drop whatever the payload owns right away
+    free_slots.push_back(slot);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename... Args>
+bool AVLTree<Key, Value, Compare, Augment>::try_emplace(const Key & key, Args &&... args) {
+    // an existing key leaves both the tree shape and its payload untouched
+    if (find(root, key)) return false;
+    insert(root, key, acquire(std::forward<Args>(args)...));
+    return true;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+bool AVLTree<Key, Value, Compare, Augment>::insert_or_assign(const Key & key, Value value) {
+    // assigning to an existing key only writes its slot, no rebalancing
+    if (auto node = find(root, key)) {
+        values[node->slot] = std::move(value);
+        return false;
+    }
+    insert(root, key, acquire(std::move(value)));
+    return true;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+Value * AVLTree<Key, Value, Compare, Augment>::get(const Key & key) {
+    auto node = find(root, key);
+    return (node) ? &values[node->slot] : nullptr;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto AVLTree<Key, Value, Compare, Augment>::insert(node_type & iterator, const Key & key, size_type slot) -> decltype(iterator) {
+    if (!iterator) {
+        iterator = new AVLNode<Key, typename Augment::data>(key, slot);
+        TreeStats::count(Counters::allocations);
+    }
+    else if (less(key, iterator->key)) {
+        iterator->left = insert(iterator->left, key, slot);
+        if (height(iterator->left) - height(iterator->right) == 2) {
+            if (less(key, iterator->left->key)) iterator = right_rotate(iterator);
+            else iterator = left_right_rotate(iterator);
+        }
+    }
+    else {
+        iterator->right = insert(iterator->right, key, slot);
+        if (height(iterator->right) - height(iterator->left) == 2) {
+            if (less(iterator->right->key, key)) iterator = left_rotate(iterator);
+            else iterator = right_left_rotate(iterator);
+        }
+    }
+    update(iterator);
+    return iterator;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto AVLTree<Key, Value, Compare, Augment>::remove(node_type & iterator, const Key & key) -> decltype(iterator) {
+    if (!iterator) return iterator;
+    if (less(key, iterator->key)) {
+        iterator->left = remove(iterator->left, key);
+    }
+    else if (less(iterator->key, key)) {
+        iterator->right = remove(iterator->right, key);
+    }
+    else if (iterator->left && iterator->right) {
+        // the replacement's slot travels with its key, and the slot being
+        // removed goes down with the replacement node to be released there
+        if (height(iterator->left) <= height(iterator->right)) {
+            auto successor = get_leftmost_child(iterator->right);
+            iterator->key = successor->key;
+            std::swap(iterator->slot, successor->slot);
+            TreeStats::count(Counters::swaps);
+            iterator->right = remove(iterator->right, iterator->key);
+        }
+        else {
+            auto predecessor = get_rightmost_child(iterator->left);
+            iterator->key = predecessor->key;
+            std::swap(iterator->slot, predecessor->slot);
+            TreeStats::count(Counters::swaps);
+            iterator->left = remove(iterator->left, iterator->key);
+        }
+    }
+    else {
+        auto temp = iterator;
+        iterator = (iterator->left) ? iterator->left : iterator->right;
+        release(temp->slot);
+        delete temp;
+        return iterator;
+    }
+
+    // deletion on either side could potentially lead to imbalance
+    if (height(iterator->left) - height(iterator->right) == 2) {
+        // iterator is the top node
+        // iterator->left is the middle node
+        if (height(iterator->left->left) >= height(iterator->left->right))
+            iterator = right_rotate(iterator);
+        else
+            iterator = left_right_rotate(iterator);
+    }
+    else if (height(iterator->right) - height(iterator->left) == 2) {
+        if (height(iterator->right->right) >= height(iterator->right->left))
+            iterator = left_rotate(iterator);
+        else
+            iterator = right_left_rotate(iterator);
+    }
+    update(iterator);
+    return iterator;
+}
+
+// frees a detached subtree and its slots, with no rebalancing on the way
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::free_subtree(node_type node) {
+    if (node == nullptr) return;
+    free_subtree(node->left);
+    free_subtree(node->right);
+    release(node->slot);
+    delete node;
+}
+
+// the tree of left, middle and right, where every key of left is before
+// middle and every key of right after it. the shorter tree hangs from the
+// spine of the taller one where heights meet, so it costs their difference
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto AVLTree<Key, Value, Compare, Augment>::join(node_type left, node_type middle, node_type right) -> node_type {
+    if (height(left) > height(right) + 1) return join_right(left, middle, right);
+    if (height(right) > height(left) + 1) return join_left(left, middle, right);
+    middle->left = left;
+    middle->right = right;
+    update(middle);
+    return middle;
+}
+
+// down the right spine of the taller left tree, rotating on the way back up
+// wherever the new subtree made a node lean two levels right
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto AVLTree<Key, Value, Compare, Augment>::join_right(node_type left, node_type middle, node_type right) -> node_type {
+    if (height(left->right) <= height(right) + 1) {
+        middle->left = left->right;
+        middle->right = right;
+        update(middle);
+        left->right = middle;
+        if (height(middle) <= height(left->left) + 1) {
+            update(left);
+            return left;
+        }
+        left->right = right_rotate(middle);
+        return left_rotate(left);
+    }
+    left->right = join_right(left->right, middle, right);
+    update(left);
+    if (height(left->right) <= height(left->left) + 1) return left;
+    return left_rotate(left);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto AVLTree<Key, Value, Compare, Augment>::join_left(node_type left, node_type middle, node_type right) -> node_type {
+    if (height(right->left) <= height(left) + 1) {
+        middle->left = left;
+        middle->right = right->left;
+        update(middle);
+        right->left = middle;
+        if (height(middle) <= height(right->right) + 1) {
+            update(right);
+            return right;
+        }
+        right->left = left_rotate(middle);
+        return right_rotate(right);
+    }
+    right->left = join_left(left, middle, right->left);
+    update(right);
+    if (height(right->left) <= height(right->right) + 1) return right;
+    return right_rotate(right);
+}
+
+// the same with no middle node: the smallest key of right is split off to be it
+template <typename Key, typename Value, typename Compare, typename Augment>
+auto AVLTree<Key, Value, Compare, Augment>::join(node_type left, node_type right) -> node_type {
+    if (!right) return left;
+    node_type middle, rest;
+    split(right, get_leftmost_child(right)->key, true, middle, rest);
+    return join(left, middle, rest);
+}
+
+// cuts the tree under node into the keys before key (up to and including
+// it if inclusive) and the rest. each node on the search path is joined
+// back to the side it belongs to, and the joins along one side cost a
+// telescoping sum of height differences, O(log n) in all
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::split(node_type node, const Key & key, bool inclusive, node_type & left, node_type & right) {
+    if (!node) {
+        left = right = nullptr;
+        return;
+    }
+    auto lower = node->left, upper = node->right;
+    node->left = node->right = nullptr;
+    node->height = 1;
+    node_type first, second;
+    if (inclusive ? !less(key, node->key) : less(node->key, key)) {
+        split(upper, key, inclusive, first, second);
+        left = join(lower, node, first);
+        right = second;
+    }
+    else {
+        split(lower, key, inclusive, first, second);
+        left = first;
+        right = join(second, node, upper);
+    }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::erase_range(const Key & low, const Key & high) {
+    if (less(high, low)) return;
+    node_type below, rest, inside, above;
+    split(root, low, false, below, rest);
+    split(rest, high, true, inside, above);
+    free_subtree(inside);
+    root = join(below, above);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::truncate_below(const Key & x) {
+    node_type below, rest;
+    split(root, x, false, below, rest);
+    free_subtree(below);
+    root = rest;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::find(node_type node, const Key & key) const {
+    while (node) {
+        if (less(key, node->key)) node = node->left;
+        else if (less(node->key, key)) node = node->right;
+        else break;
+    }
+    return node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::get_leftmost_child(node_type node) const {
+    if (!node->left && !node->right) return node;
+    else if (node->left) return get_leftmost_child(node->left);
+    else return node;
+//    else if (!node->left && node->right) return get_leftmost_child(node->right);
+//    else return get_leftmost_child(node->left);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment> // a node's left substree's right most child
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::get_rightmost_child(node_type node) const {
+    if (!node->left && !node->right) return node;
+    else if (node->right) return get_rightmost_child(node->right);
+    else return node;
+//    else if (node->left && !node->right) { return get_rightmost_child(node->left); }
+//    else return get_rightmost_child(node->right);
+}
+
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::preorder_traverse(node_type node) const {
+    if (node == nullptr) { return; }
+    std::cout << node->key << " ";
+    preorder_traverse(node->left);
+    preorder_traverse(node->right);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::inorder_traverse(node_type node) const {
+    if (node == nullptr) return;
+    inorder_traverse(node->left);
+    std::cout << node->key << " ";
+    inorder_traverse(node->right);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Function>
+void AVLTree<Key, Value, Compare, Augment>::inorder_visit(node_type node, Function & function) const {
+    if (node == nullptr) return;
+    inorder_visit(node->left, function);
+    function(static_cast<const Key &>(node->key), values[node->slot]);
+    inorder_visit(node->right, function);
+}
+
+// inorder_visit that skips the subtrees wholly outside [low, high]; false
+// once the function has asked to stop
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Function>
+bool AVLTree<Key, Value, Compare, Augment>::range_visit(node_type node, const Key & low, const Key & high, Function & function) const {
+    while (node) {
+        if (less(node->key, low)) node = node->right;
+        else if (less(high, node->key)) node = node->left;
+        else break;
+    }
+    if (node == nullptr) return true;
+    return range_visit(node->left, low, high, function)
+        && visit_entry(function, static_cast<const Key &>(node->key), values[node->slot])
+        && range_visit(node->right, low, high, function);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::postorder_traverse(node_type node) const {
+    if (node == nullptr) return;
+    postorder_traverse(node->left);
+    postorder_traverse(node->right);
+    std::cout << node->key << " ";
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::destroy(node_type node) {
+    if (node == nullptr) return;
+    if (node == root) {
+        destroy(root->left);
+        destroy(root->right);
+        delete root;
+        root = nullptr;
+        return;
+    }
+    // retrive information
+    auto parent = get_parent(node, root);
+    if (parent != nullptr) {
+        if (parent->left == node) { parent->left = nullptr; }
+        else parent->right = nullptr;
+    }
+    destroy(node->left);
+    destroy(node->right);
+    delete node;
+    return;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Iterator>
+void AVLTree<Key, Value, Compare, Augment>::bulk_load(Iterator first, Iterator last) {
+    destroy(root);
+    values.clear();
+    free_slots.clear();
+    size_type n = last - first;
+    values.reserve(n);
+    root = build(first, 0, n);
+}
+
+// cut at the midpoints, so the two sides of every node differ in size by at
+// most one and in height by at most one
+template <typename Key, typename Value, typename Compare, typename Augment>
+template <typename Iterator>
+auto AVLTree<Key, Value, Compare, Augment>::build(Iterator first, size_type low, size_type high) -> node_type {
+    if (low >= high) return nullptr;
+    auto mid = low + (high - low) / 2;
+    // built in order, so the value column ends up in key order as well
+    auto left = build(first, low, mid);
+    auto node = new AVLNode<Key, typename Augment::data>(first[mid].first, acquire(first[mid].second));
+    TreeStats::count(Counters::allocations);
+    node->left = left;
+    node->right = build(first, mid + 1, high);
+    update(node);
+    return node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+void AVLTree<Key, Value, Compare, Augment>::print(enum Directions direction) const {
+    switch (direction) {
+        case Directions::preorder: {
+            preorder_traverse(root);
+            break;
+        }
+        case Directions::inorder: {
+            inorder_traverse(root);
+            break;
+        }
+        case Directions::postorder: {
+            postorder_traverse(root);
+            break;
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::get_parent(node_type node, node_type parent) const {
+    // keys are unique, so the path to the parent follows the key
+    if (node == nullptr || parent == nullptr || node == parent) return node_type(nullptr);
+    while (parent->left != node && parent->right != node) {
+        TreeStats::count(Counters::get_parent);
+        parent = (less(node->key, parent->key)) ? parent->left : parent->right;
+        if (parent == nullptr) break;
+    }
+    return parent;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::left_rotate(node_type top) {
+    auto middle = top->right;
+    top->right = middle->left;
+    middle->left = top;
+    TreeStats::count(Counters::rotations);
+
+    update(top);
+    update(middle);
+
+    return middle;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::right_rotate(node_type top) {
+    auto middle = top->left;
+    top->left = middle->right;
+    middle->right = top;
+    TreeStats::count(Counters::rotations);
+
+    update(top);
+    update(middle);
+
+    return middle;
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::left_right_rotate(node_type top) {
+    top->left = left_rotate(top->left);
+    return right_rotate(top);
+}
+
+template <typename Key, typename Value, typename Compare, typename Augment>
+decltype(auto) AVLTree<Key, Value, Compare, Augment>::right_left_rotate(node_type top) {
+    top->right = right_rotate(top->right);
+    return left_rotate(top);
+}
+
+#endif
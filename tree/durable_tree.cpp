@@ -0,0 +1,26 @@
+#include <sstream>
+
+#include "durable_tree.h"
+
+int main(int argc, char * argv[]) {
+    DurableTree<int> tree((argc > 1) ? argv[1] : "durable_tree.db");
+    std::cout << "recovered: ";
+    tree.tree.print(RedBlackTree<int>::Directions::inorder); std::cout << std::endl;
+
+    std::cout << "Input here: " << std::endl;
+    int temp;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> temp) { tree.insert(temp); }
+
+    std::cout << "Delete: ";
+    if (std::cin >> temp) tree.remove(temp);
+    tree.commit();
+
+    tree.tree.print(RedBlackTree<int>::Directions::inorder); std::cout << std::endl;
+
+    std::cout << "Checkpoint? (y/n) ";
+    char answer;
+    if (std::cin >> answer && answer == 'y') tree.checkpoint();
+}
@@ -0,0 +1,306 @@
+#ifndef DURABLE_TREE_H
+#define DURABLE_TREE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// a RedBlackTree whose mutations survive a restart
+//
+// <directory>/wal         append-only log of assignments and removals
+// <directory>/checkpoint  the whole tree in key order, written from an in-order traversal
+//
+// mutations are appended to an in-memory group and reach the disk together,
+// with a single write and fsync, once `group_size` records are pending or on
+// commit(). when the log outgrows `checkpoint_bytes` a new checkpoint is
+// written and the log starts over.
+//
+// recovery reads the checkpoint sequentially, bulk-loads it without a single
+// rotation and replays the log tail. every logged operation is an assignment
+// or a removal, so replaying a log that the checkpoint already covers (a crash
+// between the two steps of checkpoint()) leaves the same contents.
+template <typename Key, typename Value = Empty, typename Compare = std::less<Key>>
+class DurableTree {
+    static_assert(std::is_trivially_copyable<Key>::value, "keys are stored as raw bytes");
+    static_assert(std::is_trivially_copyable<Value>::value, "values are stored as raw bytes");
+
+    using size_type = std::size_t;
+    enum Operations : std::uint8_t { assign = 1, erase = 2 };
+
+    static constexpr size_type key_size = sizeof(Key);
+    static constexpr size_type value_size = std::is_empty<Value>::value ? 0 : sizeof(Value);
+    // op, key, value, checksum
+    static constexpr size_type record_size = 1 + key_size + value_size + sizeof(std::uint32_t);
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t key_size;
+        std::uint32_t value_size;
+        std::uint32_t reserved;
+        std::uint64_t count;
+    };
+
+    public:
+    RedBlackTree<Key, Value, Compare> tree;
+
+    private:
+    std::string directory;
+    int wal;                       // file descriptor of the log
+    std::vector<char> group;       // records not yet written
+    size_type group_size;
+    size_type checkpoint_bytes;
+    size_type wal_bytes;
+
+    static std::uint64_t checksum(const char * data, size_type size);
+    std::string path(const char * name) const { return directory + "/" + name; }
+
+    void append(Operations op, const Key & key, const Value & value);
+    void recover();
+    void load_checkpoint();
+    void replay_wal();
+    void open_wal(int flags);
+
+    public:
+    explicit DurableTree(std::string dir, size_type group = 256, size_type checkpoint = 64 << 20);
+    ~DurableTree();
+
+    bool insert(const Key & key, Value value = Value()) { return !tree.find(key) && insert_or_assign(key, value); }
+    bool insert_or_assign(const Key & key, Value value);
+    void remove(const Key & key);
+    decltype(auto) find(const Key & key) const { return tree.find(key); }
+    Value * get(const Key & key) { return tree.get(key); }
+
+    void commit();
+    void checkpoint();
+};
+
+template <typename Key, typename Value, typename Compare>
+DurableTree<Key, Value, Compare>::DurableTree(std::string dir, size_type group, size_type checkpoint)
+    : directory(std::move(dir)), wal(-1), group_size(group), checkpoint_bytes(checkpoint), wal_bytes(0) {
+    ::mkdir(directory.c_str(), 0755);
+    recover();
+}
+
+template <typename Key, typename Value, typename Compare>
+DurableTree<Key, Value, Compare>::~DurableTree() {
+    // must not throw: callers who need to know the last group reached the disk call commit() first
+    try { commit(); }
+    catch (const std::exception & e) { std::cerr << e.what() << std::endl; }
+    if (wal >= 0) ::close(wal);
+}
+
+// FNV-1a, enough to tell a torn or partially written record from a good one
+template <typename Key, typename Value, typename Compare>
+std::uint64_t DurableTree<Key, Value, Compare>::checksum(const char * data, size_type size) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (size_type i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename Key, typename Value, typename Compare>
+bool DurableTree<Key, Value, Compare>::insert_or_assign(const Key & key, Value value) {
+    // apply before logging: a full group may trigger a checkpoint that must see this change
+    auto inserted = tree.insert_or_assign(key, value);
+    append(Operations::assign, key, value);
+    return inserted;
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::remove(const Key & key) {
+    if (!tree.find(key)) return;
+    tree.remove(key);
+    append(Operations::erase, key, Value());
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::append(Operations op, const Key & key, const Value & value) {
+    auto offset = group.size();
+    group.resize(offset + record_size);
+    auto record = group.data() + offset;
+    record[0] = static_cast<char>(op);
+    std::memcpy(record + 1, &key, key_size);
+    if (value_size) std::memcpy(record + 1 + key_size, &value, value_size);
+    auto sum = static_cast<std::uint32_t>(checksum(record, record_size - sizeof(std::uint32_t)));
+    std::memcpy(record + record_size - sizeof(std::uint32_t), &sum, sizeof(sum));
+    if (group.size() >= group_size * record_size) commit();
+}
+
+// group commit: one write and one fsync for every pending record
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::commit() {
+    if (group.empty()) return;
+    // on failure the log is cut back to its last synced group, so the group
+    // stays pending and a retry appends it whole, not after a torn record
+    // that would end the replay early and lose the groups behind it
+    auto fail = [&](const std::string & what) {
+        if (::ftruncate(wal, wal_bytes) != 0) throw std::runtime_error(what + ", and cannot truncate it");
+        throw std::runtime_error(what);
+    };
+    size_type written = 0;
+    while (written < group.size()) {
+        auto n = ::write(wal, group.data() + written, group.size() - written);
+        if (n < 0) fail("cannot append to " + path("wal"));
+        written += n;
+    }
+    if (::fsync(wal) != 0) fail("cannot sync " + path("wal"));
+    wal_bytes += group.size();
+    group.clear();
+    if (wal_bytes >= checkpoint_bytes) checkpoint();
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::checkpoint() {
+    std::vector<char> buffer(sizeof(Header));
+    Header header = {};
+    std::memcpy(header.magic, "RBTCKPT", 8);
+    header.version = 1;
+    header.key_size = key_size;
+    header.value_size = value_size;
+    header.count = tree.size();
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    buffer.reserve(sizeof(Header) + header.count * (key_size + value_size) + sizeof(std::uint64_t));
+    tree.for_each([&](const Key & key, const Value & value) {
+        auto offset = buffer.size();
+        buffer.resize(offset + key_size + value_size);
+        std::memcpy(buffer.data() + offset, &key, key_size);
+        if (value_size) std::memcpy(buffer.data() + offset + key_size, &value, value_size);
+    });
+    auto sum = checksum(buffer.data() + sizeof(Header), buffer.size() - sizeof(Header));
+    buffer.insert(buffer.end(), reinterpret_cast<char *>(&sum), reinterpret_cast<char *>(&sum) + sizeof(sum));
+
+    // write aside and rename, so a crash leaves either the old or the new checkpoint
+    auto temp = path("checkpoint.tmp");
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("cannot create " + temp);
+    size_type written = 0;
+    while (written < buffer.size()) {
+        auto n = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (n < 0) { ::close(fd); throw std::runtime_error("cannot write " + temp); }
+        written += n;
+    }
+    if (::fsync(fd) != 0) { ::close(fd); throw std::runtime_error("cannot sync " + temp); }
+    ::close(fd);
+    if (::rename(temp.c_str(), path("checkpoint").c_str()) != 0) throw std::runtime_error("cannot install " + temp);
+    // make the rename itself durable
+    fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        auto synced = ::fsync(fd);
+        ::close(fd);
+        if (synced != 0) throw std::runtime_error("cannot sync " + directory);
+    }
+
+    // the checkpoint now covers every logged operation, and the pending
+    // records, already applied to the tree: only now can they be dropped.
+    // until then a failure leaves them pending, for the next commit to log
+    auto old = wal;
+    try { open_wal(O_TRUNC); }
+    catch (...) { wal = old; throw; }
+    if (old >= 0) ::close(old);
+    group.clear();
+    wal_bytes = 0;
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::open_wal(int flags) {
+    wal = ::open(path("wal").c_str(), O_RDWR | O_CREAT | O_APPEND | flags, 0644);
+    if (wal < 0) throw std::runtime_error("cannot open " + path("wal"));
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::recover() {
+    load_checkpoint();
+    open_wal(0);
+    replay_wal();
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::load_checkpoint() {
+    int fd = ::open(path("checkpoint").c_str(), O_RDONLY);
+    if (fd < 0) return;  // nothing checkpointed yet
+    struct stat st;
+    if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("cannot stat " + path("checkpoint")); }
+    std::vector<char> buffer(st.st_size);
+    size_type done = 0;
+    while (done < buffer.size()) {
+        auto n = ::read(fd, buffer.data() + done, buffer.size() - done);
+        if (n <= 0) break;
+        done += n;
+    }
+    ::close(fd);
+
+    Header header;
+    auto entry_size = key_size + value_size;
+    if (done < sizeof(Header) + sizeof(std::uint64_t)) throw std::runtime_error("truncated " + path("checkpoint"));
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (std::memcmp(header.magic, "RBTCKPT", 8) != 0 || header.version != 1
+        || header.key_size != key_size || header.value_size != value_size
+        || done != sizeof(Header) + header.count * entry_size + sizeof(std::uint64_t)) {
+        throw std::runtime_error("unrecognized " + path("checkpoint"));
+    }
+    std::uint64_t sum;
+    std::memcpy(&sum, buffer.data() + done - sizeof(sum), sizeof(sum));
+    if (sum != checksum(buffer.data() + sizeof(Header), header.count * entry_size)) {
+        throw std::runtime_error("corrupt " + path("checkpoint"));
+    }
+
+    std::vector<std::pair<Key, Value>> entries(header.count);
+    auto p = buffer.data() + sizeof(Header);
+    for (auto && entry : entries) {
+        std::memcpy(&entry.first, p, key_size);
+        if (value_size) std::memcpy(&entry.second, p + key_size, value_size);
+        p += entry_size;
+    }
+    buffer = std::vector<char>();
+    tree.bulk_load(entries.begin(), entries.end());
+}
+
+template <typename Key, typename Value, typename Compare>
+void DurableTree<Key, Value, Compare>::replay_wal() {
+    struct stat st;
+    if (::fstat(wal, &st) != 0) throw std::runtime_error("cannot stat " + path("wal"));
+    std::vector<char> buffer(st.st_size);
+    size_type done = 0;
+    while (done < buffer.size()) {
+        auto n = ::pread(wal, buffer.data() + done, buffer.size() - done, done);
+        if (n <= 0) break;
+        done += n;
+    }
+
+    size_type offset = 0;
+    for (; offset + record_size <= done; offset += record_size) {
+        auto record = buffer.data() + offset;
+        std::uint32_t sum;
+        std::memcpy(&sum, record + record_size - sizeof(sum), sizeof(sum));
+        if (sum != static_cast<std::uint32_t>(checksum(record, record_size - sizeof(sum)))) break;
+
+        Key key;
+        Value value = Value();
+        std::memcpy(&key, record + 1, key_size);
+        if (value_size) std::memcpy(&value, record + 1 + key_size, value_size);
+        if (record[0] == Operations::assign) tree.insert_or_assign(key, value);
+        else if (record[0] == Operations::erase) tree.remove(key);
+        else break;
+    }
+    // drop a torn tail so new groups are appended after the last good record
+    if (offset != static_cast<size_type>(st.st_size) && ::ftruncate(wal, offset) != 0) {
+        throw std::runtime_error("cannot truncate " + path("wal"));
+    }
+    wal_bytes = offset;
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// epoch-based reclamation for structures whose readers take no locks: a node
+// unlinked by one thread may still be in the hands of another, so it is
+// retired rather than freed, and freed once every thread has moved on
+//
+// a thread works inside an EpochGuard, which publishes the global epoch it
+// saw. the epoch advances only when every thread inside a guard has seen the
+// current one, so anything retired during epoch e was unreachable to every
+// thread that pinned e + 1 or later, and is freed once the epoch reaches
+// e + 2. each thread keeps three bags of retired nodes, one per epoch mod 3
+class Epochs {
+    public:
+    using Deleter = void (*)(void *);
+
+    private:
+    // one per thread, reused after the thread exits, never freed
+    struct Record {
+        std::atomic<std::uint64_t> state;  // epoch << 1 | inside a guard
+        std::atomic<bool> in_use;
+        Record * next;
+        std::uint64_t epoch;               // the epoch of the last pin
+        unsigned depth;                    // nested guards
+        std::size_t retired;
+        std::vector<std::pair<void *, Deleter>> bags[3];
+
+        Record() : state(0), in_use(true), next(nullptr), epoch(0), depth(0), retired(0) {}
+    };
+
+    std::atomic<std::uint64_t> global;
+    std::atomic<Record *> records;
+
+    Epochs() : global(0), records(nullptr) {}
+
+    static void drain(std::vector<std::pair<void *, Deleter>> & bag) {
+        for (auto && item : bag) item.second(item.first);
+        bag.clear();
+    }
+
+    Record * acquire() {
+        for (auto record = records.load(); record; record = record->next) {
+            bool free = false;
+            if (record->in_use.compare_exchange_strong(free, true)) return record;
+        }
+        auto record = new Record();
+        record->next = records.load();
+        while (!records.compare_exchange_weak(record->next, record)) {}
+        return record;
+    }
+
+    // the calling thread's record, handed back when the thread exits; the
+    // bags it still holds are freed by the next thread to take it
+    Record & local() {
+        struct Owner {
+            Record * record;
+            explicit Owner(Record * r) : record(r) {}
+            ~Owner() { record->in_use.store(false); }
+        };
+        static thread_local Owner owner(acquire());
+        return *owner.record;
+    }
+
+    // the epoch moves on only once every thread inside a guard has seen it
+    void try_advance() {
+        auto epoch = global.load();
+        for (auto record = records.load(); record; record = record->next) {
+            auto state = record->state.load();
+            if ((state & 1) && (state >> 1) != epoch) return;
+        }
+        global.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    public:
+    ~Epochs() {
+        auto record = records.load();
+        while (record) {
+            for (auto && bag : record->bags) drain(bag);
+            auto next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    // one domain for the whole process, so a thread has one record whatever
+    // structures it touches
+    static Epochs & instance() {
+        static Epochs epochs;
+        return epochs;
+    }
+
+    void pin() {
+        auto & record = local();
+        if (record.depth++) return;
+        auto epoch = global.load();
+        record.state.store(epoch << 1 | 1);
+        if (epoch != record.epoch) {
+            // the bag of epoch - 2, whose nodes no thread can still hold
+            drain(record.bags[(epoch + 1) % 3]);
+            record.epoch = epoch;
+        }
+    }
+
+    void unpin() {
+        auto & record = local();
+        if (--record.depth) return;
+        record.state.store(record.epoch << 1);
+    }
+
+    // node is unlinked, and deleter(node) runs once no thread can reach it;
+    // called inside a guard. the bag is that of the global epoch, not the
+    // one this thread pinned: the global epoch may be one ahead, and threads
+    // that pinned it may hold the node too
+    void retire(void * node, Deleter deleter) {
+        auto & record = local();
+        record.bags[global.load() % 3].emplace_back(node, deleter);
+        if (++record.retired % 64 == 0) try_advance();
+    }
+};
+
+class EpochGuard {
+    public:
+    EpochGuard() { Epochs::instance().pin(); }
+    ~EpochGuard() { Epochs::instance().unpin(); }
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard & operator=(const EpochGuard &) = delete;
+};
+
+#endif
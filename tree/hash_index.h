@@ -0,0 +1,221 @@
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// an open-addressing hash map laid out like a Swiss table: one control byte
+// per slot, in groups of 16, holding either 7 bits of the key's hash or a
+// marker for an empty or deleted slot. a lookup loads the control bytes of a
+// group and compares all 16 with the hash's 7 bits at once (one SSE2 compare,
+// or a loop without it), and only the slots that match compare keys, so a
+// probe touches the key array about once; it stops at the first group with
+// an empty slot. groups are probed quadratically
+//
+// with a limit, the map is a cache of at most `limit` entries: a lookup sets
+// the entry's referenced bit, and an insertion into a full cache evicts by
+// CLOCK, a hand sweeping the slots, clearing referenced bits until it comes
+// to an entry without one. the capacity is fixed when the limit is set
+template <typename Key, typename Mapped, typename Hash = std::hash<Key>>
+class HashIndex {
+    static constexpr std::size_t group_width = 16;
+    static constexpr std::int8_t empty = -128;
+    static constexpr std::int8_t deleted = -2;
+
+    struct Slot {
+        Key key;
+        Mapped mapped;
+        bool referenced;
+    };
+
+    std::vector<std::int8_t> control;  // >= 0 full, with the low 7 bits of the hash
+    std::vector<Slot> slots;
+    std::size_t count;
+    std::size_t tombstones;
+    std::size_t limit;                 // 0 for no limit
+    std::size_t hand;                  // CLOCK's, an index into slots
+    Hash hasher;
+
+    std::size_t capacity() const { return slots.size(); }
+    // at most 7/8 of the slots full or deleted
+    std::size_t max_load() const { return capacity() - capacity() / 8; }
+    // std::hash of an integer is the integer, so its bits are spread before
+    // the low 7 become the tag and the ones above pick the group
+    static std::size_t mix(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        return std::size_t(h ^ (h >> 33));
+    }
+
+    // bit i set where control byte i of the group at first equals tag
+    std::uint32_t match(std::size_t first, std::int8_t tag) const;
+    std::size_t locate(const Key & key) const;
+    void rehash(std::size_t new_capacity);
+    void vacate(std::size_t i);
+    void evict();
+
+    public:
+    explicit HashIndex(std::size_t limit = 0) : count(0), tombstones(0), limit(0), hand(0) { set_limit(limit); }
+
+    // 0 removes the limit; otherwise the capacity is sized for the limit and
+    // any entries past it are evicted now
+    void set_limit(std::size_t new_limit);
+    std::size_t size() const { return count; }
+    void clear();
+
+    // the mapped value of key, or null; marks it referenced
+    Mapped * find(const Key & key);
+    bool contains(const Key & key) const { return locate(key) != capacity(); }
+    // returns whether key was new; a full cache evicts first
+    bool insert_or_assign(const Key & key, Mapped mapped);
+    // sets key's mapped value only when it is present
+    bool assign(const Key & key, Mapped mapped);
+    bool erase(const Key & key);
+};
+
+template <typename Key, typename Mapped, typename Hash>
+std::uint32_t HashIndex<Key, Mapped, Hash>::match(std::size_t first, std::int8_t tag) const {
+#if defined(__SSE2__)
+    auto group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(control.data() + first));
+    return std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(tag)))));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < group_width; ++i) mask |= std::uint32_t(control[first + i] == tag) << i;
+    return mask;
+#endif
+}
+
+// key's slot, or capacity() when it is absent
+template <typename Key, typename Mapped, typename Hash>
+std::size_t HashIndex<Key, Mapped, Hash>::locate(const Key & key) const {
+    if (!count) return capacity();
+    auto h = mix(hasher(key));
+    auto tag = std::int8_t(h & 0x7f);
+    auto groups = capacity() / group_width;
+    auto group = (h >> 7) & (groups - 1);
+    for (std::size_t step = 1; step <= groups; ++step) {
+        auto first = group * group_width;
+        for (auto mask = match(first, tag); mask; mask &= mask - 1) {
+            auto i = first + std::size_t(__builtin_ctz(mask));
+            if (slots[i].key == key) return i;
+        }
+        if (match(first, empty)) break;
+        group = (group + step) & (groups - 1);
+    }
+    return capacity();
+}
+
+template <typename Key, typename Mapped, typename Hash>
+void HashIndex<Key, Mapped, Hash>::rehash(std::size_t new_capacity) {
+    std::vector<std::int8_t> old_control(new_capacity, empty);
+    std::vector<Slot> old_slots(new_capacity);
+    old_control.swap(control);
+    old_slots.swap(slots);
+    count = tombstones = 0;
+    hand = 0;
+    for (std::size_t i = 0; i < old_slots.size(); ++i) {
+        if (old_control[i] >= 0) insert_or_assign(old_slots[i].key, std::move(old_slots[i].mapped));
+    }
+}
+
+template <typename Key, typename Mapped, typename Hash>
+void HashIndex<Key, Mapped, Hash>::evict() {
+    while (true) {
+        if (control[hand] >= 0) {
+            if (!slots[hand].referenced) {
+                vacate(hand);
+                return;
+            }
+            slots[hand].referenced = false;
+        }
+        hand = (hand + 1) & (capacity() - 1);
+    }
+}
+
+template <typename Key, typename Mapped, typename Hash>
+void HashIndex<Key, Mapped, Hash>::set_limit(std::size_t new_limit) {
+    limit = new_limit;
+    while (limit && count > limit) evict();
+    std::size_t wanted = group_width;
+    // at most half full, so the tombstones evictions leave take many
+    // insertions to reach the load factor and the sweeps stay rare
+    while (limit && wanted / 2 < limit) wanted *= 2;
+    if (!limit && capacity()) return;
+    rehash(wanted);
+}
+
+template <typename Key, typename Mapped, typename Hash>
+void HashIndex<Key, Mapped, Hash>::clear() {
+    control.assign(capacity(), empty);
+    count = tombstones = 0;
+    hand = 0;
+}
+
+template <typename Key, typename Mapped, typename Hash>
+Mapped * HashIndex<Key, Mapped, Hash>::find(const Key & key) {
+    auto i = locate(key);
+    if (i == capacity()) return nullptr;
+    slots[i].referenced = true;
+    return &slots[i].mapped;
+}
+
+template <typename Key, typename Mapped, typename Hash>
+bool HashIndex<Key, Mapped, Hash>::assign(const Key & key, Mapped mapped) {
+    auto i = locate(key);
+    if (i == capacity()) return false;
+    slots[i].mapped = std::move(mapped);
+    return true;
+}
+
+template <typename Key, typename Mapped, typename Hash>
+bool HashIndex<Key, Mapped, Hash>::insert_or_assign(const Key & key, Mapped mapped) {
+    if (assign(key, mapped)) return false;
+    if (limit && count >= limit) evict();
+    // tombstones alone past the load factor only need sweeping out
+    if (count + tombstones + 1 > max_load()) rehash((limit || count + 1 <= capacity() / 2) ? capacity() : capacity() * 2);
+
+    auto h = mix(hasher(key));
+    auto groups = capacity() / group_width;
+    auto group = (h >> 7) & (groups - 1);
+    for (std::size_t step = 1; ; ++step) {
+        auto first = group * group_width;
+        auto mask = match(first, empty) | match(first, deleted);
+        if (mask) {
+            auto i = first + std::size_t(__builtin_ctz(mask));
+            if (control[i] == deleted) --tombstones;
+            control[i] = std::int8_t(h & 0x7f);
+            slots[i] = Slot{ key, std::move(mapped), false };
+            ++count;
+            return true;
+        }
+        group = (group + step) & (groups - 1);
+    }
+}
+
+template <typename Key, typename Mapped, typename Hash>
+bool HashIndex<Key, Mapped, Hash>::erase(const Key & key) {
+    auto i = locate(key);
+    if (i == capacity()) return false;
+    vacate(i);
+    return true;
+}
+
+// a group with an empty slot has never been full since the last rehash, so
+// no probe went on past it and the slot can go straight back to empty;
+// otherwise it becomes a tombstone, which probes step over
+template <typename Key, typename Mapped, typename Hash>
+void HashIndex<Key, Mapped, Hash>::vacate(std::size_t i) {
+    if (match(i & ~(group_width - 1), empty)) control[i] = empty;
+    else {
+        control[i] = deleted;
+        ++tombstones;
+    }
+    --count;
+}
+
+#endif
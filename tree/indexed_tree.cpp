@@ -0,0 +1,31 @@
+#include <limits>
+
+#include "indexed_tree.h"
+#include "RedBlackTree/RedBlackTree/red_black_tree.h"
+
+int main() {
+    // every key in the index
+    IndexedTree<int> tree;
+    tree.create();
+    tree.for_each([](int key, const Empty &) { std::cout << key << " "; });
+    std::cout << std::endl;
+
+    int temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    std::cout << (tree.contains(temp) ? "found" : "not found") << std::endl;
+
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    tree.remove(temp);
+    tree.scan(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), [](int key, const Empty &) { std::cout << key << " "; });
+    std::cout << std::endl;
+
+    // only the 4 most recently found keys in the index
+    IndexedTree<int, RedBlackTree<int>> cached(4);
+    for (int key = 0; key < 100; ++key) cached.insert(key);
+    for (int round = 0; round < 3; ++round) {
+        for (int key = 0; key < 100; key += 10) cached.find(key);
+    }
+    std::cout << "size " << cached.size() << ", indexed " << cached.indexed() << std::endl;
+}
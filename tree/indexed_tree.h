@@ -0,0 +1,146 @@
+#ifndef INDEXED_TREE_H
+#define INDEXED_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include "hash_index.h"
+#include "avl_tree.h"
+
+// an ordered tree with a hash index from keys to its nodes beside it: point
+// lookups go to the index, O(1) instead of a walk down the whole height,
+// while ordered and range queries still go to the tree. Tree is AVLTree or
+// RedBlackTree
+//
+// with capacity 0 the index holds every key, so a miss there is an answer
+// and find never touches the tree. otherwise it is a cache of at most
+// `capacity` keys, filled by finds that had to go to the tree and evicted by
+// CLOCK, for when only the hot keys are worth the memory
+//
+// keeping it in sync relies on two things both trees do: rotations relink
+// nodes without moving keys between them, and removing a node with two
+// children copies its neighbour's key into it and frees the neighbour's node
+// instead. so a removal retargets at most one other key, at a node known
+// beforehand
+template <typename Key, typename Tree = AVLTree<Key>, typename Hash = std::hash<Key>>
+class IndexedTree {
+    using node_type = decltype(std::declval<Tree &>().root);
+    using value_type = typename std::decay<decltype(std::declval<Tree &>().value(std::declval<node_type>()))>::type;
+
+    Tree tree;
+    mutable HashIndex<Key, node_type, Hash> index;
+    bool cache;
+
+    void unindex(const Key & low, const Key & high, bool inclusive);
+
+    public:
+    explicit IndexedTree(std::size_t capacity = 0) : index(capacity), cache(capacity != 0) {}
+
+    void create();
+    bool insert(const Key & key) { return try_emplace(key); }
+    bool insert(const Key & key, value_type value) { return try_emplace(key, std::move(value)); }
+    template <typename... Args> bool try_emplace(const Key & key, Args &&... args);
+    bool insert_or_assign(const Key & key, value_type value);
+    void remove(const Key & key);
+    void erase_range(const Key & low, const Key & high);
+    void truncate_below(const Key & x);
+
+    node_type find(const Key & key) const;
+    bool contains(const Key & key) const { return find(key) != nullptr; }
+    value_type * get(const Key & key);
+
+    std::size_t size() const { return tree.size(); }
+    std::size_t indexed() const { return index.size(); }
+    // ordered and range queries, and anything else the tree offers
+    const Tree & ordered() const { return tree; }
+    template <typename Function> void for_each(Function function) const { tree.for_each(function); }
+    template <typename Function> void scan(const Key & low, const Key & high, Function function) const { tree.scan(low, high, function); }
+};
+
+template <typename Key, typename Tree, typename Hash>
+void IndexedTree<Key, Tree, Hash>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+// the tree's insert does not hand back the node, so a full index pays a
+// second descent for it; a cache leaves new keys to the finds
+template <typename Key, typename Tree, typename Hash>
+template <typename... Args>
+bool IndexedTree<Key, Tree, Hash>::try_emplace(const Key & key, Args &&... args) {
+    if (!tree.try_emplace(key, std::forward<Args>(args)...)) return false;
+    if (!cache) index.insert_or_assign(key, tree.find(key));
+    return true;
+}
+
+template <typename Key, typename Tree, typename Hash>
+bool IndexedTree<Key, Tree, Hash>::insert_or_assign(const Key & key, value_type value) {
+    if (!tree.insert_or_assign(key, std::move(value))) return false;
+    if (!cache) index.insert_or_assign(key, tree.find(key));
+    return true;
+}
+
+template <typename Key, typename Tree, typename Hash>
+void IndexedTree<Key, Tree, Hash>::remove(const Key & key) {
+    // not through find, which would cache a key about to go
+    auto hit = index.find(key);
+    auto node = hit ? *hit : tree.find(key);
+    if (!node) return;
+    // with two children the node survives, holding whichever neighbour's
+    // key the tree moves into it
+    bool survives = node->left && node->right;
+    tree.remove(key);
+    index.erase(key);
+    if (survives) index.assign(node->key, node);
+}
+
+// the keys from low up to high out of the index, before the tree frees their nodes
+template <typename Key, typename Tree, typename Hash>
+void IndexedTree<Key, Tree, Hash>::unindex(const Key & low, const Key & high, bool inclusive) {
+    std::vector<Key> keys;
+    tree.scan(low, high, [&](const Key & key, const value_type &) {
+        if (inclusive || !(key == high)) keys.push_back(key);
+    });
+    for (auto && key : keys) index.erase(key);
+}
+
+template <typename Key, typename Tree, typename Hash>
+void IndexedTree<Key, Tree, Hash>::erase_range(const Key & low, const Key & high) {
+    unindex(low, high, true);
+    tree.erase_range(low, high);
+}
+
+template <typename Key, typename Tree, typename Hash>
+void IndexedTree<Key, Tree, Hash>::truncate_below(const Key & x) {
+    if (!tree.root) return;
+    auto first = tree.root;
+    while (first->left) first = first->left;
+    unindex(first->key, x, false);
+    tree.truncate_below(x);
+}
+
+template <typename Key, typename Tree, typename Hash>
+auto IndexedTree<Key, Tree, Hash>::find(const Key & key) const -> node_type {
+    if (auto hit = index.find(key)) return *hit;
+    if (!cache) return nullptr;
+    auto node = tree.find(key);
+    if (node) index.insert_or_assign(key, node);
+    return node;
+}
+
+template <typename Key, typename Tree, typename Hash>
+auto IndexedTree<Key, Tree, Hash>::get(const Key & key) -> value_type * {
+    auto node = find(key);
+    return node ? &tree.value(node) : nullptr;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+
+#include "interval_tree.h"
+
+int main() {
+    IntervalTree<int> tree;
+    std::cout << "Input here (low high pairs): " << std::endl;
+    int low, high;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> low >> high) { tree.insert({ low, high }); }
+
+    std::cout << "Overlap: ";
+    std::cin >> low >> high;
+    tree.overlap(low, high, [](const Interval<int> & interval, const Empty &) {
+        std::cout << "[" << interval.low << ", " << interval.high << "] ";
+    });
+    std::cout << std::endl;
+
+    int point;
+    std::cout << "Stab: ";
+    std::cin >> point;
+    tree.stab(point, [](const Interval<int> & interval, const Empty &) {
+        std::cout << "[" << interval.low << ", " << interval.high << "] ";
+    });
+    std::cout << std::endl;
+}
@@ -0,0 +1,126 @@
+#ifndef INTERVAL_TREE_H
+#define INTERVAL_TREE_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// closed interval [low, high]
+template <typename T>
+struct Interval {
+    T low;
+    T high;
+
+    bool overlaps(const T & a, const T & b) const { return !(high < a) && !(b < low); }
+};
+
+// orders by low endpoint, ties by high, so equal starts can coexist
+template <typename T>
+struct IntervalLess {
+    bool operator()(const Interval<T> & lhs, const Interval<T> & rhs) const {
+        return lhs.low < rhs.low || (!(rhs.low < lhs.low) && lhs.high < rhs.high);
+    }
+};
+
+// every node knows the largest high endpoint in its subtree
+template <typename T>
+struct MaxEndpoint {
+    struct data { T max; };
+
+    template <typename Node>
+    static void update(Node * node) {
+        node->max = node->key.high;
+        if (node->left && node->max < node->left->max) node->max = node->left->max;
+        if (node->right && node->max < node->right->max) node->max = node->right->max;
+    }
+};
+
+// interval tree on top of RedBlackTree: intervals are the keys, ordered by
+// their low endpoint, and the max-endpoint summary prunes every subtree that
+// ends before the query starts. a query visits O((k + 1) log n) nodes for k hits
+template <typename T, typename Value = Empty>
+class IntervalTree {
+    using tree_type = RedBlackTree<Interval<T>, Value, IntervalLess<T>, MaxEndpoint<T>>;
+    using node_type = decltype(std::declval<tree_type &>().root);
+    using size_type = std::size_t;
+
+    public:
+    tree_type tree;
+
+    private:
+    template <typename Function>
+    void overlap(node_type node, const T & a, const T & b, Function & function) const;
+    template <typename Function>
+    void overlap(node_type node, const std::vector<Interval<T>> & queries,
+                 size_type * active, size_type count, size_type * scratch, Function & function) const;
+
+    public:
+    bool insert(const Interval<T> & interval, Value value = Value()) { return tree.insert(interval, std::move(value)); }
+    void remove(const Interval<T> & interval) { tree.remove(interval); }
+    size_type size() const { return tree.size(); }
+
+    // calls function(interval, value) for every stored interval that overlaps [a, b]
+    template <typename Function>
+    void overlap(const T & a, const T & b, Function function) const { overlap(tree.root, a, b, function); }
+    // calls function(interval, value) for every stored interval that contains point
+    template <typename Function>
+    void stab(const T & point, Function function) const { overlap(tree.root, point, point, function); }
+
+    // answers all queries in one walk of the tree, calling function(query index,
+    // interval, value); each node is read once per batch instead of once per query
+    template <typename Function>
+    void overlap(const std::vector<Interval<T>> & queries, Function function) const;
+};
+
+template <typename T, typename Value>
+template <typename Function>
+void IntervalTree<T, Value>::overlap(node_type node, const T & a, const T & b, Function & function) const {
+    // nothing below ends at or after a
+    if (!node || node->max < a) return;
+    overlap(node->left, a, b, function);
+    // everything on the right starts after b once this node does
+    if (b < node->key.low) return;
+    if (node->key.overlaps(a, b)) function(node->key, tree.value(node));
+    overlap(node->right, a, b, function);
+}
+
+template <typename T, typename Value>
+template <typename Function>
+void IntervalTree<T, Value>::overlap(const std::vector<Interval<T>> & queries, Function function) const {
+    // each level of the walk keeps the indices of the queries still alive
+    // there in its own slice of one buffer, so the batch allocates once
+    size_type n = queries.size();
+    unsigned levels = 2;
+    for (auto m = size(); m; m >>= 1) levels += 2;
+    std::vector<size_type> buffer(n * (levels + 1));
+    std::iota(buffer.begin(), buffer.begin() + n, 0);
+    overlap(tree.root, queries, buffer.data(), n, buffer.data() + n, function);
+}
+
+template <typename T, typename Value>
+template <typename Function>
+void IntervalTree<T, Value>::overlap(node_type node, const std::vector<Interval<T>> & queries,
+                                     size_type * active, size_type count, size_type * scratch, Function & function) const {
+    if (!node || !count) return;
+    // keep the queries that can still meet something in this subtree
+    size_type alive = 0;
+    for (size_type i = 0; i < count; ++i) {
+        if (!(node->max < queries[active[i]].low)) scratch[alive++] = active[i];
+    }
+    if (!alive) return;
+    overlap(node->left, queries, scratch, alive, scratch + alive, function);
+
+    size_type right = 0;
+    for (size_type i = 0; i < alive; ++i) {
+        auto & query = queries[scratch[i]];
+        if (query.high < node->key.low) continue;
+        if (node->key.overlaps(query.low, query.high)) function(scratch[i], node->key, tree.value(node));
+        scratch[right++] = scratch[i];
+    }
+    overlap(node->right, queries, scratch, right, scratch + alive, function);
+}
+
+#endif
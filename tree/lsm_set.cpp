@@ -0,0 +1,24 @@
+#include "lsm_set.h"
+
+int main() {
+    // a tiny buffer, so that even a few keys reach the levels
+    LSMSet<int> set(4, 2);
+    set.create();
+    auto print = [&set] {
+        set.scan(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), [](int key) { std::cout << key << " "; });
+        std::cout << std::endl;
+    };
+    print();
+    std::cout << "levels: " << set.level_count() << std::endl;
+
+    int temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    std::cout << (set.find(temp) ? "found" : "not found") << std::endl;
+
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    set.remove(temp);
+
+    print();
+}
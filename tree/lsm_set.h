@@ -0,0 +1,272 @@
+#ifndef LSM_SET_H
+#define LSM_SET_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cstdint>
+
+#include "../sort/mergesort.h"
+#include "../sort/kway_merge.h"
+
+// a bit array answering "maybe present" or "certainly absent" for the keys it
+// was built from. blocked: a key's 7 probes all fall in one 64-bit word that
+// its hash picks, so adding or testing a key touches one cache line. at 10
+// bits per key that costs some accuracy over free probes, about 2% false
+// positives instead of 1%, for a seventh of the cache misses
+template <typename Key, typename Hash = std::hash<Key>>
+class BloomFilter {
+    std::vector<std::uint64_t> words;
+    Hash hash;
+
+    static std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+    // the word from the high half of the hash. the probes need 7 * 6 = 42
+    // bits, more than the low half holds, so they come from 6-bit slices of
+    // a second mix of the hash, which shares no bits with the word's choice
+    std::size_t word_of(std::uint64_t h) const { return std::size_t(((h >> 32) * words.size()) >> 32); }
+    static std::uint64_t mask_of(std::uint64_t h) {
+        std::uint64_t mask = 0;
+        h = mix(h ^ 0x9e3779b97f4a7c15ull);
+        for (unsigned i = 0; i < probes; ++i, h >>= 6) mask |= std::uint64_t(1) << (h & 63);
+        return mask;
+    }
+
+    public:
+    static constexpr unsigned probes = 7;
+
+    void clear() { words.clear(); }
+    void reset(std::size_t keys) { words.assign((keys * 10 + 63) / 64 + 1, 0); }
+    void add(const Key & key) {
+        auto h = mix(hash(key));
+        words[word_of(h)] |= mask_of(h);
+    }
+    bool may_contain(const Key & key) const {
+        if (words.empty()) return false;
+        auto h = mix(hash(key));
+        auto mask = mask_of(h);
+        return (words[word_of(h)] & mask) == mask;
+    }
+};
+
+// an ordered set for write-heavy loads, log-structured: insertions and
+// removals are appended to a small unsorted buffer, with no search and no
+// rebalancing. a full buffer is sorted with naturalmergesort and merged into
+// level 0, a sorted array; a level that outgrows its capacity, `fanout` times
+// the one above, is merged into the next one down. every key is thus copied
+// about fanout / 2 times per level, all of it sequential, where a balanced
+// tree pays a pointer-chasing descent per key
+//
+// a removal is a tombstone entry that hides older copies of its key until a
+// merge into the deepest level drops both. lookups go newest to oldest: the
+// buffer, then each level with a binary search, each behind a Bloom filter
+template <typename Key, typename Compare = std::less<Key>, typename Hash = std::hash<Key>>
+class LSMSet {
+    struct Entry {
+        Key key;
+        bool erased;
+
+        // by key only, so the stable kernels keep equal keys in write order
+        bool operator<(const Entry & rhs) const { return Compare()(key, rhs.key); }
+        bool operator<=(const Entry & rhs) const { return !Compare()(rhs.key, key); }
+        bool operator>(const Entry & rhs) const { return Compare()(rhs.key, key); }
+        bool operator>=(const Entry & rhs) const { return !Compare()(key, rhs.key); }
+    };
+
+    // a source for kway_merge over part of a sorted run
+    struct Cursor {
+        const Entry * first;
+        const Entry * last;
+        using value_type = Entry;
+        bool next(Entry & entry) {
+            if (first == last) return false;
+            entry = *first++;
+            return true;
+        }
+    };
+
+    struct Level {
+        std::vector<Entry> run;  // sorted, one entry per key
+        BloomFilter<Key, Hash> filter;
+    };
+
+    std::vector<Entry> buffer;
+    BloomFilter<Key, Hash> buffer_filter;  // spares lookups the scan of the buffer
+    std::vector<Entry> temp;
+    std::vector<Level> levels;  // levels[0] is the newest
+    std::size_t buffer_capacity;
+    std::size_t fanout;
+    Compare comp;
+
+    std::size_t capacity(std::size_t level) const;
+    void merge_runs(const std::vector<Entry> & newer, const std::vector<Entry> & older, std::vector<Entry> & out, bool deepest) const;
+    const Entry * lookup(const Key & key) const;
+
+    public:
+    explicit LSMSet(std::size_t buffer_capacity = 8192, std::size_t fanout = 8)
+        : buffer_capacity(buffer_capacity ? buffer_capacity : 1), fanout((fanout > 1) ? fanout : 2) {
+        buffer.reserve(this->buffer_capacity);
+        buffer_filter.reset(this->buffer_capacity);
+    }
+
+    void create();
+    // no result, unlike the trees' insert: knowing whether the key was
+    // there would take the lookup that writes here are meant to avoid
+    void insert(const Key & key);
+    void remove(const Key & key);
+    bool find(const Key & key) const;
+
+    // sorts and merges the buffer now, as a full one would be
+    void flush();
+    // calls function(key) on every key in [low, high], in order
+    template <typename Function> void scan(const Key & low, const Key & high, Function function) const;
+    std::size_t level_count() const { return levels.size(); }
+};
+
+template <typename Key, typename Compare, typename Hash>
+void LSMSet<Key, Compare, Hash>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+template <typename Key, typename Compare, typename Hash>
+std::size_t LSMSet<Key, Compare, Hash>::capacity(std::size_t level) const {
+    auto result = buffer_capacity * fanout;
+    for (std::size_t i = 0; i < level; ++i) result *= fanout;
+    return result;
+}
+
+template <typename Key, typename Compare, typename Hash>
+void LSMSet<Key, Compare, Hash>::insert(const Key & key) {
+    buffer.push_back({ key, false });
+    buffer_filter.add(key);
+    if (buffer.size() >= buffer_capacity) flush();
+}
+
+template <typename Key, typename Compare, typename Hash>
+void LSMSet<Key, Compare, Hash>::remove(const Key & key) {
+    buffer.push_back({ key, true });
+    buffer_filter.add(key);
+    if (buffer.size() >= buffer_capacity) flush();
+}
+
+// mergearray over two separate runs: on equal keys only the newer entry is
+// kept, and a tombstone with nothing older below it is dropped
+template <typename Key, typename Compare, typename Hash>
+void LSMSet<Key, Compare, Hash>::merge_runs(const std::vector<Entry> & newer, const std::vector<Entry> & older, std::vector<Entry> & out, bool deepest) const {
+    out.clear();
+    out.reserve(newer.size() + older.size());
+    std::size_t i = 0, j = 0;
+    auto emit = [&](const Entry & entry) {
+        if (!(deepest && entry.erased)) out.push_back(entry);
+    };
+    while (i < newer.size() && j < older.size()) {
+        if (comp(newer[i].key, older[j].key)) emit(newer[i++]);
+        else if (comp(older[j].key, newer[i].key)) emit(older[j++]);
+        else {
+            emit(newer[i++]);
+            ++j;
+        }
+    }
+    while (i < newer.size()) emit(newer[i++]);
+    while (j < older.size()) emit(older[j++]);
+}
+
+template <typename Key, typename Compare, typename Hash>
+void LSMSet<Key, Compare, Hash>::flush() {
+    if (buffer.empty()) return;
+    temp.resize(buffer.size());
+    naturalmergesort(buffer, temp);
+    // equal keys sit in write order, so the last of each run is the newest
+    std::vector<Entry> run, merged;
+    run.reserve(buffer.size());
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+        if (i + 1 < buffer.size() && !comp(buffer[i].key, buffer[i + 1].key)) continue;
+        run.push_back(buffer[i]);
+    }
+    buffer.clear();
+    buffer_filter.reset(buffer_capacity);
+
+    for (std::size_t i = 0; ; ++i) {
+        if (i == levels.size()) levels.emplace_back();
+        merge_runs(run, levels[i].run, merged, i + 1 == levels.size());
+        if (merged.size() <= capacity(i)) {
+            levels[i].run.swap(merged);
+            levels[i].filter.reset(levels[i].run.size());
+            for (auto && entry : levels[i].run) levels[i].filter.add(entry.key);
+            return;
+        }
+        // too big for this level: the whole of it moves down, and it is empty again
+        std::vector<Entry>().swap(levels[i].run);
+        levels[i].filter.clear();
+        run.swap(merged);
+    }
+}
+
+// the newest entry for key, tombstone or not, or nullptr
+template <typename Key, typename Compare, typename Hash>
+const typename LSMSet<Key, Compare, Hash>::Entry * LSMSet<Key, Compare, Hash>::lookup(const Key & key) const {
+    if (buffer_filter.may_contain(key)) {
+        for (auto i = buffer.size(); i-- > 0; ) {
+            if (!comp(buffer[i].key, key) && !comp(key, buffer[i].key)) return &buffer[i];
+        }
+    }
+    for (auto && level : levels) {
+        if (!level.filter.may_contain(key)) continue;
+        auto it = std::lower_bound(level.run.begin(), level.run.end(), key,
+                                   [this](const Entry & entry, const Key & k) { return comp(entry.key, k); });
+        if (it != level.run.end() && !comp(key, it->key)) return &*it;
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Compare, typename Hash>
+bool LSMSet<Key, Compare, Hash>::find(const Key & key) const {
+    auto entry = lookup(key);
+    return entry && !entry->erased;
+}
+
+// a k-way merge over the buffer and every level, newest first: the loser
+// tree breaks ties toward the lower input, so of equal keys the newest comes
+// out first and kway_merge_unique keeps it
+template <typename Key, typename Compare, typename Hash>
+template <typename Function>
+void LSMSet<Key, Compare, Hash>::scan(const Key & low, const Key & high, Function function) const {
+    if (comp(high, low)) return;
+    auto below = [this](const Entry & entry, const Key & k) { return comp(entry.key, k); };
+    auto above = [this](const Key & k, const Entry & entry) { return comp(k, entry.key); };
+
+    // the buffer's keys in range, newest first, then stably sorted
+    std::vector<Entry> recent, scratch;
+    for (auto i = buffer.size(); i-- > 0; ) {
+        if (!comp(buffer[i].key, low) && !comp(high, buffer[i].key)) recent.push_back(buffer[i]);
+    }
+    scratch.resize(recent.size());
+    naturalmergesort(recent, scratch);
+
+    std::vector<Cursor> cursors;
+    cursors.push_back({ recent.data(), recent.data() + recent.size() });
+    for (auto && level : levels) {
+        auto first = std::lower_bound(level.run.data(), level.run.data() + level.run.size(), low, below);
+        auto last = std::upper_bound(first, level.run.data() + level.run.size(), high, above);
+        cursors.push_back({ first, last });
+    }
+    kway_merge_unique(cursors, [&](const Entry & entry) {
+        if (!entry.erased) function(entry.key);
+    }, std::less<Entry>());
+}
+
+#endif
@@ -0,0 +1,27 @@
+#include <iostream>
+
+#include "mapped_tree.h"
+
+int main(int argc, char * argv[]) {
+    std::string path = (argc > 1) ? argv[1] : "avl_tree.map";
+    {
+        AVLTree<int> tree;
+        tree.create();
+        MappedTree<int>::save(tree, path);
+    }
+
+    MappedTree<int> mapped;
+    mapped.open(path);
+    std::cout << "mapped " << mapped.size() << " keys, checksum " << (mapped.verify() ? "ok" : "bad") << std::endl;
+
+    int temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    std::cout << (mapped.contains(temp) ? "found" : "not found") << std::endl;
+
+    int low, high;
+    std::cout << "Range: ";
+    std::cin >> low >> high;
+    mapped.range(low, high, [](const int & key, const Empty &) { std::cout << key << " "; });
+    std::cout << std::endl;
+}
@@ -0,0 +1,320 @@
+#ifndef MAPPED_TREE_H
+#define MAPPED_TREE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "avl_tree.h"
+
+// a read-only AVL tree served straight out of a memory-mapped file
+//
+// the file holds a header, the nodes in preorder and the values in the same
+// order. children are node indices rather than pointers, so the image means
+// the same thing wherever it is mapped, and keys and values are fixed-width
+// raw bytes. open() only maps the file and checks the header; pages are
+// faulted in by the lookups that touch them, so opening costs the same for
+// any file size and a warm page cache serves the first query at full speed.
+template <typename Key, typename Value = Empty, typename Compare = std::less<Key>>
+class MappedTree {
+    static_assert(std::is_trivially_copyable<Key>::value, "keys are stored as raw bytes");
+    static_assert(std::is_trivially_copyable<Value>::value, "values are stored as raw bytes");
+
+    using size_type = std::size_t;
+    static constexpr std::uint64_t null = ~std::uint64_t(0);
+
+    struct DiskNode {
+        Key key;
+        std::uint64_t left;
+        std::uint64_t right;
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;   // 0x01020304 as written by the producing host
+        std::uint32_t key_size;
+        std::uint32_t value_size;
+        std::uint32_t node_size;
+        std::uint32_t reserved;
+        std::uint64_t count;
+        std::uint64_t root;
+        std::uint64_t nodes_offset;
+        std::uint64_t values_offset;
+        std::uint64_t body_checksum;  // checked on demand by verify(), not by open()
+        std::uint64_t header_checksum;
+    };
+
+    private:
+    Compare comp;
+    void * base;
+    size_type length;
+    const Header * header;
+    const DiskNode * nodes;
+    const Value * values;
+
+    // buffered writes to a new file; `hash` runs over everything after the header
+    struct Writer {
+        std::string path;
+        int fd;
+        std::vector<char> buffer;
+        std::uint64_t hash;
+
+        explicit Writer(std::string path);
+        ~Writer() { close(); }
+        void put(const void * data, size_type size);
+        void pad(size_type size);
+        void flush();
+        void close() { if (fd >= 0) ::close(fd); fd = -1; }
+    };
+
+    static std::uint64_t checksum(const char * data, size_type size, std::uint64_t hash = 14695981039346656037ull);
+    // a child index read from the file, checked before it is followed
+    std::uint64_t child(std::uint64_t parent, std::uint64_t index) const;
+    template <typename Function>
+    void range(std::uint64_t index, const Key & low, const Key & high, Function & function) const;
+
+    public:
+    MappedTree(): base(nullptr), length(0), header(nullptr), nodes(nullptr), values(nullptr) {}
+    MappedTree(const MappedTree &) = delete;
+    MappedTree & operator=(const MappedTree &) = delete;
+    ~MappedTree() { close(); }
+
+    template <typename Tree> static void save(const Tree & tree, const std::string & path);
+    void open(const std::string & path);
+    void close();
+    bool verify() const;
+
+    size_type size() const { return (header) ? header->count : 0; }
+    const Value * find(const Key & key) const;
+    bool contains(const Key & key) const { return find(key) != nullptr; }
+    // calls function(key, value) for every key in [low, high], in key order
+    template <typename Function>
+    void range(const Key & low, const Key & high, Function function) const;
+};
+
+// FNV-1a; pass the hash so far to continue one over several pieces
+template <typename Key, typename Value, typename Compare>
+std::uint64_t MappedTree<Key, Value, Compare>::checksum(const char * data, size_type size, std::uint64_t hash) {
+    for (size_type i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename Key, typename Value, typename Compare>
+MappedTree<Key, Value, Compare>::Writer::Writer(std::string path) : path(std::move(path)), hash(0) {
+    fd = ::open(this->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("cannot create " + this->path);
+    buffer.reserve(1 << 16);
+}
+
+template <typename Key, typename Value, typename Compare>
+void MappedTree<Key, Value, Compare>::Writer::put(const void * data, size_type size) {
+    auto bytes = static_cast<const char *>(data);
+    hash = checksum(bytes, size, hash);
+    if (buffer.size() + size > buffer.capacity()) flush();
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+template <typename Key, typename Value, typename Compare>
+void MappedTree<Key, Value, Compare>::Writer::pad(size_type size) {
+    static const char zeros[256] = {};
+    while (size > 0) {
+        auto n = (size < sizeof(zeros)) ? size : sizeof(zeros);
+        put(zeros, n);
+        size -= n;
+    }
+}
+
+template <typename Key, typename Value, typename Compare>
+void MappedTree<Key, Value, Compare>::Writer::flush() {
+    size_type written = 0;
+    while (written < buffer.size()) {
+        auto n = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (n < 0) throw std::runtime_error("cannot write " + path);
+        written += n;
+    }
+    buffer.clear();
+}
+
+// writes the nodes of an AVLTree in preorder, so a descent moves forward
+// through the file and a left child usually shares its parent's page.
+// the image is streamed to the file through a small buffer, the body
+// checksum kept as it goes and the header written last, so the only copy
+// held in memory is one subtree size per node: in preorder a node's left
+// child is the next node and its right child follows the left subtree
+template <typename Key, typename Value, typename Compare>
+template <typename Tree>
+void MappedTree<Key, Value, Compare>::save(const Tree & tree, const std::string & path) {
+    using node_type = decltype(tree.root);
+    std::vector<std::uint64_t> sizes;
+    std::function<std::uint64_t(node_type)> measure = [&](node_type node) -> std::uint64_t {
+        if (!node) return 0;
+        auto index = sizes.size();
+        sizes.push_back(0);
+        auto size = 1 + measure(node->left);
+        size += measure(node->right);
+        sizes[index] = size;
+        return size;
+    };
+    measure(tree.root);
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "AVLMAP", 7);
+    h.version = 1;
+    h.byte_order = 0x01020304;
+    h.key_size = sizeof(Key);
+    h.value_size = sizeof(Value);
+    h.node_size = sizeof(DiskNode);
+    h.count = sizes.size();
+    h.root = (h.count) ? 0 : null;
+    // both arrays start on a page boundary
+    auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    auto align = [page](std::uint64_t offset) { return (offset + page - 1) / page * page; };
+    h.nodes_offset = align(sizeof(Header));
+    h.values_offset = align(h.nodes_offset + h.count * sizeof(DiskNode));
+
+    auto temp = path + ".tmp";
+    Writer out(temp);
+    // the header's place, filled in once the body checksum is known
+    out.pad(h.nodes_offset);
+    out.hash = checksum(nullptr, 0);
+
+    std::uint64_t next = 0;
+    std::function<void(node_type)> write_nodes = [&](node_type node) {
+        if (!node) return;
+        auto index = next++;
+        DiskNode disk_node;
+        std::memset(&disk_node, 0, sizeof(disk_node));  // no stray padding bytes in the image
+        disk_node.key = node->key;
+        disk_node.left = (node->left) ? index + 1 : null;
+        disk_node.right = (node->right) ? index + 1 + ((node->left) ? sizes[index + 1] : 0) : null;
+        out.put(&disk_node, sizeof(disk_node));
+        write_nodes(node->left);
+        write_nodes(node->right);
+    };
+    write_nodes(tree.root);
+    out.pad(h.values_offset - (h.nodes_offset + h.count * sizeof(DiskNode)));
+    std::function<void(node_type)> write_values = [&](node_type node) {
+        if (!node) return;
+        out.put(&tree.value(node), sizeof(Value));
+        write_values(node->left);
+        write_values(node->right);
+    };
+    write_values(tree.root);
+    out.flush();
+
+    h.body_checksum = out.hash;
+    h.header_checksum = checksum(reinterpret_cast<const char *>(&h), offsetof(Header, header_checksum));
+    if (::pwrite(out.fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h))) throw std::runtime_error("cannot write " + temp);
+    if (::fsync(out.fd) != 0) throw std::runtime_error("cannot sync " + temp);
+    out.close();
+    if (::rename(temp.c_str(), path.c_str()) != 0) throw std::runtime_error("cannot install " + path);
+
+    // make the rename itself durable
+    auto slash = path.rfind('/');
+    auto directory = (slash == std::string::npos) ? std::string(".") : path.substr(0, (slash) ? slash : 1);
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        auto synced = ::fsync(fd);
+        ::close(fd);
+        if (synced != 0) throw std::runtime_error("cannot sync " + directory);
+    }
+}
+
+template <typename Key, typename Value, typename Compare>
+void MappedTree<Key, Value, Compare>::open(const std::string & path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("cannot stat " + path); }
+    length = st.st_size;
+    if (length < sizeof(Header)) { ::close(fd); throw std::runtime_error("truncated " + path); }
+    base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file alive
+    if (base == MAP_FAILED) { base = nullptr; throw std::runtime_error("cannot map " + path); }
+
+    auto h = static_cast<const Header *>(base);
+    bool valid = std::memcmp(h->magic, "AVLMAP", 7) == 0 && h->version == 1 && h->byte_order == 0x01020304
+        && h->key_size == sizeof(Key) && h->value_size == sizeof(Value) && h->node_size == sizeof(DiskNode)
+        && h->header_checksum == checksum(static_cast<const char *>(base), offsetof(Header, header_checksum))
+        && h->nodes_offset + h->count * sizeof(DiskNode) <= length
+        && h->values_offset + h->count * sizeof(Value) <= length
+        && (h->root == null || h->root < h->count);
+    if (!valid) { close(); throw std::runtime_error("unrecognized " + path); }
+
+    header = h;
+    nodes = reinterpret_cast<const DiskNode *>(static_cast<const char *>(base) + h->nodes_offset);
+    values = reinterpret_cast<const Value *>(static_cast<const char *>(base) + h->values_offset);
+}
+
+template <typename Key, typename Value, typename Compare>
+void MappedTree<Key, Value, Compare>::close() {
+    if (base) ::munmap(base, length);
+    base = nullptr;
+    length = 0;
+    header = nullptr;
+    nodes = nullptr;
+    values = nullptr;
+}
+
+// reads the whole body, so it costs a full scan; open() stays O(1)
+template <typename Key, typename Value, typename Compare>
+bool MappedTree<Key, Value, Compare>::verify() const {
+    if (!header) return false;
+    auto body = static_cast<const char *>(base) + header->nodes_offset;
+    auto size = header->values_offset + header->count * sizeof(Value) - header->nodes_offset;
+    return checksum(body, size) == header->body_checksum;
+}
+
+// preorder puts every child after its parent, so besides keeping reads
+// inside the mapping this keeps a damaged file from sending a walk in circles
+template <typename Key, typename Value, typename Compare>
+std::uint64_t MappedTree<Key, Value, Compare>::child(std::uint64_t parent, std::uint64_t index) const {
+    if (index != null && (index <= parent || index >= header->count)) throw std::runtime_error("corrupt node in mapped tree");
+    return index;
+}
+
+template <typename Key, typename Value, typename Compare>
+const Value * MappedTree<Key, Value, Compare>::find(const Key & key) const {
+    auto index = (header) ? header->root : null;
+    while (index != null) {
+        auto & node = nodes[index];
+        if (comp(key, node.key)) index = child(index, node.left);
+        else if (comp(node.key, key)) index = child(index, node.right);
+        else return &values[index];
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename Function>
+void MappedTree<Key, Value, Compare>::range(const Key & low, const Key & high, Function function) const {
+    if (header) range(header->root, low, high, function);
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename Function>
+void MappedTree<Key, Value, Compare>::range(std::uint64_t index, const Key & low, const Key & high, Function & function) const {
+    if (index == null) return;
+    auto & node = nodes[index];
+    // only subtrees that can hold keys inside [low, high] are paged in
+    if (comp(low, node.key)) range(child(index, node.left), low, high, function);
+    if (!comp(node.key, low) && !comp(high, node.key)) function(node.key, values[index]);
+    if (comp(node.key, high)) range(child(index, node.right), low, high, function);
+}
+
+#endif
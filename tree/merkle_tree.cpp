@@ -0,0 +1,34 @@
+#include <sstream>
+
+#include "merkle_tree.h"
+
+int main() {
+    MerkleTree<int, int> primary, replica;
+    std::cout << "Input here: " << std::endl;
+    std::string line;
+    std::getline(std::cin, line);
+    std::vector<int> keys;
+    std::istringstream iss(line);
+    for (int key; iss >> key; ) keys.push_back(key);
+
+    // the same entries in opposite orders: different shapes, one hash
+    for (auto key : keys) primary.insert(key, key * 10);
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) replica.insert(*it, *it * 10);
+    std::cout << "hashes " << (primary.root_hash() == replica.root_hash() ? "agree" : "differ") << std::endl;
+
+    int temp;
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    primary.remove(temp);
+    std::cout << "Change: ";
+    std::cin >> temp;
+    primary.insert_or_assign(temp, -temp);
+
+    auto ranges = primary.diff(replica);
+    std::stringstream delta;
+    primary.export_delta(ranges, delta);
+    std::cout << delta.str();
+    replica.import_delta(delta);
+    std::cout << "after sync hashes " << (primary.root_hash() == replica.root_hash() ? "agree" : "differ") << std::endl;
+    replica.for_each([](int key, int value) { std::cout << key << ":" << value << " "; });
+}
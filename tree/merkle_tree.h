@@ -0,0 +1,281 @@
+#ifndef MERKLE_TREE_H
+#define MERKLE_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+
+#include "avl_tree.h"
+
+// an AVLTree whose every node knows a hash of its whole subtree, so two
+// copies of the same map, say replicas in different processes, can find
+// where they differ without comparing every entry
+//
+// a subtree's hash is the sum, mod 2^64, of one mixed hash per entry of key
+// and value. a sum does not depend on the shape of the tree, and replicas
+// built in different orders have different shapes, and it subtracts: the
+// hash of any key range is two O(log n) descents, sum below its end minus sum
+// below its start. it guards against accidents, not against an adversary
+// choosing keys to collide
+template <typename Key, typename Value = Empty, typename Compare = std::less<Key>, typename Hash = std::hash<Key>>
+class MerkleTree {
+    // the tree's key carries the entry's hash, so update() sees the value too
+    struct Entry {
+        Key key;
+        std::uint64_t digest;
+    };
+    struct EntryLess {
+        Compare comp;
+        bool operator()(const Entry & lhs, const Entry & rhs) const { return comp(lhs.key, rhs.key); }
+    };
+    struct SubtreeHash {
+        struct data {
+            std::uint64_t hash;
+            std::size_t count;
+        };
+        template <typename Node>
+        static void update(Node * node) {
+            node->hash = node->key.digest;
+            node->count = 1;
+            if (node->left) {
+                node->hash += node->left->hash;
+                node->count += node->left->count;
+            }
+            if (node->right) {
+                node->hash += node->right->hash;
+                node->count += node->right->count;
+            }
+        }
+    };
+    using tree_type = AVLTree<Entry, Value, EntryLess, SubtreeHash>;
+    using node_type = decltype(std::declval<tree_type &>().root);
+
+    tree_type tree;
+    Compare comp;
+
+    static std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+    static std::uint64_t digest(const Key & key, const Value & value);
+    static Entry probe(const Key & key) { return { key, 0 }; }
+
+    // hash and count of the entries before key, or up to and including it
+    std::pair<std::uint64_t, std::size_t> below(const Key & key, bool inclusive) const;
+    // the same over the keys strictly between the bounds, a null bound being open
+    std::pair<std::uint64_t, std::size_t> between(const Key * low, const Key * high) const;
+    // the first key after low and the last before high, both strictly
+    const Key * first_after(const Key * low) const;
+    const Key * last_before(const Key * high) const;
+    template <typename Report>
+    void diff(node_type node, const Key * low, const Key * high, const MerkleTree & other, Report & report) const;
+
+    public:
+    MerkleTree() {}
+
+    void create();
+    bool insert(const Key & key, Value value = Value()) { return tree.insert(Entry{ key, digest(key, value) }, std::move(value)); }
+    // a new value changes the entry's hash, which the path above has to see,
+    // so an existing entry is taken out and put back
+    bool insert_or_assign(const Key & key, Value value);
+    void remove(const Key & key) { tree.remove(probe(key)); }
+    const Value * get(const Key & key) const;
+    bool find(const Key & key) const { return tree.find(probe(key)) != nullptr; }
+    std::size_t size() const { return tree.size(); }
+    void erase_range(const Key & low, const Key & high) { tree.erase_range(probe(low), probe(high)); }
+    // calls function(key, value) for every entry in key order
+    template <typename Function> void for_each(Function function) const;
+
+    std::uint64_t root_hash() const { return tree.root ? tree.root->hash : 0; }
+    // the hash of the entries in [low, high]; two replicas agree on a range
+    // when these agree, which lets processes that cannot see each other's
+    // trees bisect towards their differences a message at a time
+    std::uint64_t range_hash(const Key & low, const Key & high) const;
+
+    // closed ranges [low, high] that together hold every key where other
+    // differs from this map: missing from one side, or with another value.
+    // subtrees with equal hashes are skipped whole, so for d differences it
+    // visits O(d log n) nodes, each with an O(log n) range hash of other
+    std::vector<std::pair<Key, Key>> diff(const MerkleTree & other) const;
+    // this map's entries in the given ranges, as text: a line "range low high
+    // count" per range, then a line "key value" (just "key" for sets) per entry
+    void export_delta(const std::vector<std::pair<Key, Key>> & ranges, std::ostream & os) const;
+    // replaces each range of a delta with its entries; after
+    //   replica.import_delta(primary.export_delta(primary.diff(replica)))
+    // the replica equals the primary, at a cost that grows with the change
+    void import_delta(std::istream & is);
+};
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+std::uint64_t MerkleTree<Key, Value, Compare, Hash>::digest(const Key & key, const Value & value) {
+    auto h = mix(std::uint64_t(Hash()(key)));
+    if constexpr (!std::is_same<Value, Empty>::value) h = mix(h ^ (std::uint64_t(std::hash<Value>()(value)) + 0x9e3779b97f4a7c15ull));
+    else (void)value;
+    return h;
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+void MerkleTree<Key, Value, Compare, Hash>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+bool MerkleTree<Key, Value, Compare, Hash>::insert_or_assign(const Key & key, Value value) {
+    auto node = tree.find(probe(key));
+    if (node && node->key.digest == digest(key, value)) return false;
+    if (node) tree.remove(probe(key));
+    tree.insert(Entry{ key, digest(key, value) }, std::move(value));
+    return !node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+const Value * MerkleTree<Key, Value, Compare, Hash>::get(const Key & key) const {
+    auto node = tree.find(probe(key));
+    return node ? &tree.value(node) : nullptr;
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+template <typename Function>
+void MerkleTree<Key, Value, Compare, Hash>::for_each(Function function) const {
+    tree.for_each([&](const Entry & entry, const Value & value) { function(entry.key, value); });
+}
+
+// each node left behind on the way down brings its left subtree along
+template <typename Key, typename Value, typename Compare, typename Hash>
+std::pair<std::uint64_t, std::size_t> MerkleTree<Key, Value, Compare, Hash>::below(const Key & key, bool inclusive) const {
+    std::uint64_t hash = 0;
+    std::size_t count = 0;
+    for (auto node = tree.root; node; ) {
+        if (inclusive ? comp(key, node->key.key) : !comp(node->key.key, key)) {
+            node = node->left;
+            continue;
+        }
+        hash += node->key.digest;
+        ++count;
+        if (node->left) {
+            hash += node->left->hash;
+            count += node->left->count;
+        }
+        node = node->right;
+    }
+    return { hash, count };
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+std::pair<std::uint64_t, std::size_t> MerkleTree<Key, Value, Compare, Hash>::between(const Key * low, const Key * high) const {
+    std::pair<std::uint64_t, std::size_t> upper(root_hash(), size()), lower(0, 0);
+    if (high) upper = below(*high, false);
+    if (low) lower = below(*low, true);
+    return { upper.first - lower.first, upper.second - lower.second };
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+const Key * MerkleTree<Key, Value, Compare, Hash>::first_after(const Key * low) const {
+    const Key * found = nullptr;
+    for (auto node = tree.root; node; ) {
+        if (!low || comp(*low, node->key.key)) {
+            found = &node->key.key;
+            node = node->left;
+        }
+        else node = node->right;
+    }
+    return found;
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+const Key * MerkleTree<Key, Value, Compare, Hash>::last_before(const Key * high) const {
+    const Key * found = nullptr;
+    for (auto node = tree.root; node; ) {
+        if (!high || comp(node->key.key, *high)) {
+            found = &node->key.key;
+            node = node->right;
+        }
+        else node = node->left;
+    }
+    return found;
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+std::uint64_t MerkleTree<Key, Value, Compare, Hash>::range_hash(const Key & low, const Key & high) const {
+    if (comp(high, low)) return 0;
+    return below(high, true).first - below(low, false).first;
+}
+
+// node's subtree holds exactly this map's keys strictly between low and
+// high, so it is compared with other's entries between the same bounds
+template <typename Key, typename Value, typename Compare, typename Hash>
+template <typename Report>
+void MerkleTree<Key, Value, Compare, Hash>::diff(node_type node, const Key * low, const Key * high, const MerkleTree & other, Report & report) const {
+    auto theirs = other.between(low, high);
+    if (!node) {
+        // nothing here, so everything there differs
+        if (theirs.second) report(*other.first_after(low), *other.last_before(high));
+        return;
+    }
+    if (node->hash == theirs.first && node->count == theirs.second) return;
+    const Key & key = node->key.key;
+    diff(node->left, low, &key, other, report);
+    auto match = other.tree.find(probe(key));
+    if (!match || match->key.digest != node->key.digest) report(key, key);
+    diff(node->right, &key, high, other, report);
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+std::vector<std::pair<Key, Key>> MerkleTree<Key, Value, Compare, Hash>::diff(const MerkleTree & other) const {
+    std::vector<std::pair<Key, Key>> ranges;
+    auto report = [&](const Key & low, const Key & high) { ranges.emplace_back(low, high); };
+    diff(tree.root, nullptr, nullptr, other, report);
+    return ranges;
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+void MerkleTree<Key, Value, Compare, Hash>::export_delta(const std::vector<std::pair<Key, Key>> & ranges, std::ostream & os) const {
+    for (auto && range : ranges) {
+        std::vector<std::pair<const Key *, const Value *>> entries;
+        tree.scan(probe(range.first), probe(range.second), [&](const Entry & entry, const Value & value) {
+            entries.emplace_back(&entry.key, &value);
+        });
+        os << "range " << range.first << " " << range.second << " " << entries.size() << "\n";
+        for (auto && entry : entries) {
+            os << *entry.first;
+            if constexpr (!std::is_same<Value, Empty>::value) os << " " << *entry.second;
+            os << "\n";
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Compare, typename Hash>
+void MerkleTree<Key, Value, Compare, Hash>::import_delta(std::istream & is) {
+    std::string tag;
+    while (is >> tag) {
+        Key low, high;
+        std::size_t count;
+        if (tag != "range" || !(is >> low >> high >> count)) throw std::runtime_error("malformed delta");
+        erase_range(low, high);
+        for (std::size_t i = 0; i < count; ++i) {
+            Key key;
+            Value value{};
+            if (!(is >> key)) throw std::runtime_error("malformed delta");
+            if constexpr (!std::is_same<Value, Empty>::value) {
+                if (!(is >> value)) throw std::runtime_error("malformed delta");
+            }
+            insert(key, std::move(value));
+        }
+    }
+}
+
+#endif
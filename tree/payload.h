@@ -0,0 +1,29 @@
+#ifndef PAYLOAD_H
+#define PAYLOAD_H
+
+#include <type_traits>
+
+// payload type for trees that are used as plain ordered sets
+struct Empty {};
+
+// an augmentation keeps a per-node summary of its subtree in `data` (a base of
+// the node) and recomputes it in update(node) from the node's key and its
+// children's summaries; the tree calls update() on both nodes of every
+// rotation and bottom-up along the path an insertion or removal changed
+struct NoAugment {
+    struct data {};
+    template <typename Node> static void update(Node *) {}
+};
+
+// calls a visitor on one entry: visitors returning bool stop a walk by
+// returning false, and ones returning nothing always go on
+template <typename Function, typename Key, typename Value>
+bool visit_entry(Function & function, const Key & key, const Value & value) {
+    if constexpr (std::is_same<decltype(function(key, value)), bool>::value) return function(key, value);
+    else {
+        function(key, value);
+        return true;
+    }
+}
+
+#endif
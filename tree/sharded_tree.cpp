@@ -0,0 +1,37 @@
+#include <thread>
+#include <vector>
+#include <limits>
+
+#include "sharded_tree.h"
+#include "avl_tree.h"
+
+int main() {
+    // four shards, at 0, 1000 and 2000; everything below 0 goes to the first
+    ShardedTree<int> tree({ 0, 1000, 2000 }, 256);
+    tree.create();
+    tree.for_each([](int key) { std::cout << key << " "; });
+    std::cout << std::endl;
+
+    // four writers on one range: the shard they share is split under them
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&tree, t] {
+            for (int key = 1000 + t; key < 2000; key += 4) tree.insert(key);
+        });
+    }
+    for (auto && thread : threads) thread.join();
+    std::cout << "size " << tree.size() << " in " << tree.shard_count() << " shards" << std::endl;
+
+    int temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    std::cout << (tree.find(temp) ? "found" : "not found") << std::endl;
+
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    tree.remove(temp);
+
+    ShardedTree<int, AVLTree<int>> avl({ 0 });
+    tree.scan(std::numeric_limits<int>::min(), 999, [&](int key) { avl.insert(key); });
+    avl.for_each([](int key) { std::cout << key << " "; });
+}
@@ -0,0 +1,368 @@
+#ifndef SHARDED_TREE_H
+#define SHARDED_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// an ordered set for many writers: the key space is cut into ranges, and
+// each range is a shard with its own tree and its own lock, so writers on
+// different ranges never wait for each other. an operation finds its shard
+// by a binary search of the range bounds, and a scan walks the shards its
+// range spans in order, locking one at a time, so it is ordered but not a
+// snapshot across shards
+//
+// the shards count their operations. every `interval` operations the set
+// rebalances against a fair share, the load one shard would see were it
+// spread over `max_shards`: a shard with more than twice the fair share is
+// split at its median key, and two neighbours that together have less than
+// half of it are merged. the rule looks at a shard's own share of the load,
+// not at the other shards, so a set that starts as one shard splits as soon
+// as it is busy, and one shard taking all the load keeps splitting until
+// its pieces are fair shares or max_shards is reached
+//
+// a shard being split or merged is sealed: readers go on, writers wait.
+// its entries are copied out under its own lock and the new trees are built
+// from them by bulk_load, in O(n) and holding no lock at all; the directory
+// is held exclusively only to swap them in. Tree is RedBlackTree or AVLTree,
+// or any tree with insert, remove, find, size, for_each, scan and bulk_load
+template <typename Key, typename Tree = RedBlackTree<Key>, typename Compare = std::less<Key>>
+class ShardedTree {
+    using node_type = decltype(std::declval<Tree &>().root);
+    using value_type = typename std::decay<decltype(std::declval<Tree &>().value(std::declval<node_type>()))>::type;
+    using Entries = std::vector<std::pair<Key, value_type>>;
+    using entry_iterator = typename Entries::const_iterator;
+
+    // on its own cache lines, so threads locking neighbouring shards do not
+    // fight over one
+    struct alignas(64) Shard {
+        Key low;                     // the first key owned; shard 0 owns everything below it too
+        std::mutex mutex;
+        std::unique_ptr<Tree> tree;  // swapped whole when the shard is split or merged
+        std::size_t operations;      // since the last rebalance; written under mutex
+        bool sealed;                 // being rebuilt: no writes until it is swapped in
+
+        explicit Shard(const Key & low, std::unique_ptr<Tree> tree = std::unique_ptr<Tree>(new Tree()))
+            : low(low), tree(std::move(tree)), operations(0), sealed(false) {}
+    };
+
+    // a split or a merge: the shards it replaces, first to last, and the
+    // ones that take their place
+    struct Rebuild {
+        std::vector<Shard *> from;
+        std::vector<std::unique_ptr<Shard>> to;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    // shared by every operation, exclusive while rebuilt shards are swapped in
+    mutable std::shared_mutex directory;
+    std::atomic<std::size_t> ticks;
+    std::size_t interval;
+    std::size_t max_shards;
+    Compare comp;
+    // one rebalance at a time; writers to a sealed shard wait here for it to end
+    std::mutex rebalance_mutex;
+    std::condition_variable rebalanced;
+    bool rebalancing;
+
+    std::size_t route(const Key & key) const;
+    template <typename Function> decltype(auto) with_shard(const Key & key, bool writes, Function function);
+    static std::unique_ptr<Tree> build(entry_iterator first, entry_iterator last);
+    std::vector<Rebuild> plan();
+    void install(std::vector<Rebuild> & rebuilds) noexcept;
+    void tick();
+
+    public:
+    // bounds are the first keys of shards 1 on, sorted; shard 0 takes
+    // everything below bounds[0]. interval 0 turns rebalancing off, and
+    // max_shards, raised to the initial count if below it, caps the splits
+    explicit ShardedTree(const std::vector<Key> & bounds = {}, std::size_t interval = 1 << 16, std::size_t max_shards = 64);
+    ShardedTree(const ShardedTree &) = delete;
+    ShardedTree & operator=(const ShardedTree &) = delete;
+
+    void create();
+    bool insert(const Key & key);
+    void remove(const Key & key);
+    bool find(const Key & key);
+    // calls function(key) on the keys in [low, high] in order
+    template <typename Function> void scan(const Key & low, const Key & high, Function function);
+    template <typename Function> void for_each(Function function);
+
+    std::size_t size() const;
+    std::size_t shard_count() const;
+    // splits hot shards and merges cold ones now, as every interval-th operation does
+    void rebalance();
+};
+
+template <typename Key, typename Tree, typename Compare>
+ShardedTree<Key, Tree, Compare>::ShardedTree(const std::vector<Key> & bounds, std::size_t interval, std::size_t max_shards)
+    : ticks(0), interval(interval), max_shards(max_shards), rebalancing(false) {
+    for (std::size_t i = 1; i < bounds.size(); ++i) {
+        if (!comp(bounds[i - 1], bounds[i])) throw std::runtime_error("shard bounds must be sorted and distinct");
+    }
+    shards.emplace_back(new Shard(bounds.empty() ? Key() : bounds.front()));
+    for (auto && bound : bounds) shards.emplace_back(new Shard(bound));
+    this->max_shards = std::max(max_shards, shards.size());
+}
+
+template <typename Key, typename Tree, typename Compare>
+void ShardedTree<Key, Tree, Compare>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+// the last shard whose low is not after key, or shard 0; called under directory
+template <typename Key, typename Tree, typename Compare>
+std::size_t ShardedTree<Key, Tree, Compare>::route(const Key & key) const {
+    auto it = std::upper_bound(shards.begin() + 1, shards.end(), key,
+                               [this](const Key & k, const std::unique_ptr<Shard> & shard) { return comp(k, shard->low); });
+    return std::size_t(it - shards.begin()) - 1;
+}
+
+// a writer that finds its shard sealed lets go of everything, so the
+// rebalance can take the directory, and tries again once it has finished
+template <typename Key, typename Tree, typename Compare>
+template <typename Function>
+decltype(auto) ShardedTree<Key, Tree, Compare>::with_shard(const Key & key, bool writes, Function function) {
+    while (true) {
+        {
+            std::shared_lock<std::shared_mutex> shared(directory);
+            auto & shard = *shards[route(key)];
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            if (!writes || !shard.sealed) {
+                ++shard.operations;
+                return function(*shard.tree);
+            }
+        }
+        std::unique_lock<std::mutex> wait(rebalance_mutex);
+        rebalanced.wait(wait, [this] { return !rebalancing; });
+    }
+}
+
+// rebalancing needs the directory to itself, so it runs after the
+// operation has let go of its shard
+template <typename Key, typename Tree, typename Compare>
+void ShardedTree<Key, Tree, Compare>::tick() {
+    if (interval && ++ticks % interval == 0) rebalance();
+}
+
+template <typename Key, typename Tree, typename Compare>
+bool ShardedTree<Key, Tree, Compare>::insert(const Key & key) {
+    auto inserted = with_shard(key, true, [&](Tree & tree) { return tree.insert(key); });
+    tick();
+    return inserted;
+}
+
+template <typename Key, typename Tree, typename Compare>
+void ShardedTree<Key, Tree, Compare>::remove(const Key & key) {
+    with_shard(key, true, [&](Tree & tree) { tree.remove(key); });
+    tick();
+}
+
+template <typename Key, typename Tree, typename Compare>
+bool ShardedTree<Key, Tree, Compare>::find(const Key & key) {
+    auto found = with_shard(key, false, [&](Tree & tree) { return tree.find(key) != nullptr; });
+    tick();
+    return found;
+}
+
+template <typename Key, typename Tree, typename Compare>
+template <typename Function>
+void ShardedTree<Key, Tree, Compare>::scan(const Key & low, const Key & high, Function function) {
+    if (comp(high, low)) return;
+    {
+        std::shared_lock<std::shared_mutex> shared(directory);
+        for (auto i = route(low), last = route(high); i <= last; ++i) {
+            auto & shard = *shards[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ++shard.operations;
+            shard.tree->scan(low, high, [&](const Key & key, const auto &) { function(key); });
+        }
+    }
+    tick();
+}
+
+template <typename Key, typename Tree, typename Compare>
+template <typename Function>
+void ShardedTree<Key, Tree, Compare>::for_each(Function function) {
+    std::shared_lock<std::shared_mutex> shared(directory);
+    for (auto && shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->tree->for_each([&](const Key & key, const auto &) { function(key); });
+    }
+}
+
+template <typename Key, typename Tree, typename Compare>
+std::size_t ShardedTree<Key, Tree, Compare>::size() const {
+    std::shared_lock<std::shared_mutex> shared(directory);
+    std::size_t total = 0;
+    for (auto && shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->tree->size();
+    }
+    return total;
+}
+
+template <typename Key, typename Tree, typename Compare>
+std::size_t ShardedTree<Key, Tree, Compare>::shard_count() const {
+    std::shared_lock<std::shared_mutex> shared(directory);
+    return shards.size();
+}
+
+template <typename Key, typename Tree, typename Compare>
+auto ShardedTree<Key, Tree, Compare>::build(entry_iterator first, entry_iterator last) -> std::unique_ptr<Tree> {
+    std::unique_ptr<Tree> tree(new Tree());
+    tree->bulk_load(first, last);
+    return tree;
+}
+
+// picks the shards to split and the runs of neighbours to merge, seals them
+// and builds their replacements; called with rebalancing set and no lock held
+template <typename Key, typename Tree, typename Compare>
+auto ShardedTree<Key, Tree, Compare>::plan() -> std::vector<Rebuild> {
+    std::vector<Rebuild> rebuilds;
+    std::vector<Entries> entries;
+    {
+        std::shared_lock<std::shared_mutex> shared(directory);
+        std::vector<std::size_t> operations, sizes;
+        std::size_t total = 0;
+        for (auto && shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            operations.push_back(shard->operations);
+            sizes.push_back(shard->tree->size());
+            total += shard->operations;
+        }
+        if (total == 0) return rebuilds;
+        // in units of total / max_shards, so no division rounds a share to 0
+        auto share = [&](std::size_t ops) { return double(ops) * double(max_shards) / double(total); };
+
+        auto count = shards.size();
+        for (std::size_t i = 0; i < shards.size(); ) {
+            auto seal = [&](std::size_t j) {
+                std::lock_guard<std::mutex> lock(shards[j]->mutex);
+                shards[j]->sealed = true;
+                rebuilds.back().from.push_back(shards[j].get());
+                auto & out = entries.back();
+                shards[j]->tree->for_each([&](const Key & key, const value_type & value) { out.emplace_back(key, value); });
+            };
+            if (count < max_shards && share(operations[i]) > 2 && sizes[i] >= 2) {
+                rebuilds.emplace_back();
+                entries.emplace_back();
+                seal(i);
+                ++count;
+                ++i;
+                continue;
+            }
+            // a run of neighbours that together stay under half a share
+            auto last = i;
+            auto run = operations[i];
+            while (last + 1 < shards.size() && share(run + operations[last + 1]) < 0.5) run += operations[++last];
+            if (last > i) {
+                rebuilds.emplace_back();
+                entries.emplace_back();
+                for (auto j = i; j <= last; ++j) seal(j);
+                count -= last - i;
+            }
+            i = last + 1;
+        }
+    }
+
+    // no lock while the trees are built: the sealed shards cannot change
+    for (std::size_t r = 0; r < rebuilds.size(); ++r) {
+        auto & rebuild = rebuilds[r];
+        const auto & sorted = entries[r];
+        auto low = rebuild.from.front()->low;
+        if (rebuild.from.size() == 1) {
+            // the upper half, from the median key on, becomes a shard of its own
+            auto middle = sorted.begin() + std::ptrdiff_t(sorted.size() / 2);
+            rebuild.to.emplace_back(new Shard(low, build(sorted.begin(), middle)));
+            rebuild.to.emplace_back(new Shard(middle->first, build(middle, sorted.end())));
+        }
+        else rebuild.to.emplace_back(new Shard(low, build(sorted.begin(), sorted.end())));
+        Entries().swap(entries[r]);
+    }
+    return rebuilds;
+}
+
+// swaps the rebuilt shards in under the exclusive directory lock, which is
+// all that lock covers: pointer moves into vectors reserved beforehand. the
+// old shards are freed after it is released
+template <typename Key, typename Tree, typename Compare>
+void ShardedTree<Key, Tree, Compare>::install(std::vector<Rebuild> & rebuilds) noexcept {
+    // only a rebalance changes shards, so its size can be read unlocked
+    std::vector<std::unique_ptr<Shard>> next, retired;
+    std::size_t added = 0, removed = 0;
+    for (auto && rebuild : rebuilds) {
+        added += rebuild.to.size();
+        removed += rebuild.from.size();
+    }
+    next.reserve(shards.size() + added - removed);
+    retired.reserve(removed);
+    {
+        std::unique_lock<std::shared_mutex> exclusive(directory);
+        std::size_t r = 0;
+        for (std::size_t i = 0; i < shards.size(); ) {
+            if (r == rebuilds.size() || shards[i].get() != rebuilds[r].from.front()) {
+                next.push_back(std::move(shards[i++]));
+                continue;
+            }
+            auto & rebuild = rebuilds[r++];
+            for (auto && shard : rebuild.to) next.push_back(std::move(shard));
+            for (std::size_t k = 0; k < rebuild.from.size(); ++k) retired.push_back(std::move(shards[i++]));
+        }
+        shards.swap(next);
+        for (auto && shard : shards) shard->operations = 0;
+    }
+}
+
+template <typename Key, typename Tree, typename Compare>
+void ShardedTree<Key, Tree, Compare>::rebalance() {
+    {
+        std::unique_lock<std::mutex> wait(rebalance_mutex);
+        rebalanced.wait(wait, [this] { return !rebalancing; });
+        rebalancing = true;
+    }
+    auto finish = [this] {
+        {
+            std::lock_guard<std::mutex> lock(rebalance_mutex);
+            rebalancing = false;
+        }
+        rebalanced.notify_all();
+    };
+    try {
+        auto rebuilds = plan();
+        install(rebuilds);
+    }
+    catch (...) {
+        // a failed build leaves the old shards in place, writable again
+        {
+            std::shared_lock<std::shared_mutex> shared(directory);
+            for (auto && shard : shards) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->sealed = false;
+            }
+        }
+        finish();
+        throw;
+    }
+    finish();
+}
+
+#endif
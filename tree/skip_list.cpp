@@ -0,0 +1,33 @@
+#include <thread>
+#include <vector>
+
+#include "skip_list.h"
+
+int main() {
+    SkipList<int> list;
+    list.create();
+    list.for_each([](int key) { std::cout << key << " "; });
+    std::cout << std::endl;
+
+    // four threads insert and remove the keys of their own residue class at once
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&list, t] {
+            for (int key = 1000 + t; key < 2000; key += 4) list.insert(key);
+            for (int key = 1000 + t; key < 2000; key += 8) list.remove(key);
+        });
+    }
+    for (auto && thread : threads) thread.join();
+    std::cout << "size after the threads: " << list.size() << std::endl;
+
+    int temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    std::cout << (list.find(temp) ? "found" : "not found") << std::endl;
+
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    list.remove(temp);
+
+    list.scan(std::numeric_limits<int>::min(), 999, [](int key) { std::cout << key << " "; });
+}
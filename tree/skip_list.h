@@ -0,0 +1,274 @@
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <new>
+#include <functional>
+#include <limits>
+#include <cstdint>
+
+#include "stats.h"
+#include "epoch.h"
+
+// an ordered set any number of threads can share, without locks (Herlihy and
+// Shavit's lock-free skip list). a node is a tower of `height` forward links,
+// one per level, and level 0 lists every key in order; a random height,
+// halving in odds per level, gives O(log n) expected searches
+//
+// links change only by compare-and-swap. the low bit of a link marks the
+// node that owns it as removed: remove() marks a tower from the top down,
+// and whoever marks level 0 has removed the key. searches unlink marked
+// nodes they pass, so a removal is physical soon after it is logical, and
+// the unlinked nodes go to the epoch reclamation of epoch.h. find() and
+// scan() only read, and never wait
+template <typename Key, typename Compare = std::less<Key>>
+class SkipList {
+    static constexpr int max_height = 32;
+    using link_type = std::atomic<std::uintptr_t>;
+
+    // the tower follows the node in the same allocation
+    struct alignas(link_type) Node {
+        Key key;
+        int height;
+        // the insertion, until its tower is linked, and the removal that
+        // wins it, until its search has unlinked it: the second one done
+        // retires the node
+        std::atomic<int> owners;
+
+        Node(const Key & k, int h) : key(k), height(h), owners(2) {}
+        link_type * next() { return reinterpret_cast<link_type *>(this + 1); }
+        link_type & next(int level) { return next()[level]; }
+    };
+
+    static bool marked(std::uintptr_t link) { return link & 1; }
+    static Node * pointer(std::uintptr_t link) { return reinterpret_cast<Node *>(link & ~std::uintptr_t(1)); }
+    static std::uintptr_t link(Node * node) { return reinterpret_cast<std::uintptr_t>(node); }
+
+    Node * head;  // a full-height tower before the first key
+    std::atomic<std::size_t> count;
+    Compare comp;
+
+    bool less(const Key & lhs, const Key & rhs) const { TreeStats::count(Counters::comparisons); return comp(lhs, rhs); }
+    static Node * create(const Key & key, int height);
+    static void destroy(void * node);
+    static int random_height();
+    void release(Node * node);
+    bool search(const Key & key, Node ** preds, Node ** succs);
+
+    public:
+    SkipList() : head(create(Key(), max_height)), count(0) {}
+    explicit SkipList(Compare c) : head(create(Key(), max_height)), count(0), comp(c) {}
+    // not safe while other threads still use the list
+    ~SkipList();
+    SkipList(const SkipList &) = delete;
+    SkipList & operator=(const SkipList &) = delete;
+
+    void create();
+    bool insert(const Key & key);
+    bool remove(const Key & key);
+    bool find(const Key & key) const;
+    // calls function(key) on the keys in [low, high] in order; a key inserted
+    // or removed during the scan may or may not be seen
+    template <typename Function> void scan(const Key & low, const Key & high, Function function) const;
+    template <typename Function> void for_each(Function function) const;
+    // exact when no update is under way
+    std::size_t size() const { return count.load(); }
+};
+
+template <typename Key, typename Compare>
+typename SkipList<Key, Compare>::Node * SkipList<Key, Compare>::create(const Key & key, int height) {
+    TreeStats::count(Counters::allocations);
+    auto memory = ::operator new(sizeof(Node) + sizeof(link_type) * height);
+    auto node = new (memory) Node(key, height);
+    for (int level = 0; level < height; ++level) new (&node->next(level)) link_type(0);
+    return node;
+}
+
+template <typename Key, typename Compare>
+void SkipList<Key, Compare>::destroy(void * memory) {
+    auto node = static_cast<Node *>(memory);
+    node->~Node();
+    ::operator delete(memory);
+}
+
+template <typename Key, typename Compare>
+int SkipList<Key, Compare>::random_height() {
+    static thread_local std::uint64_t state = 0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+    // xorshift; each trailing one bit adds a level
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int height = 1;
+    for (auto bits = state; (bits & 1) && height < max_height; bits >>= 1) ++height;
+    return height;
+}
+
+template <typename Key, typename Compare>
+void SkipList<Key, Compare>::release(Node * node) {
+    if (node->owners.fetch_sub(1) == 1) Epochs::instance().retire(node, destroy);
+}
+
+template <typename Key, typename Compare>
+SkipList<Key, Compare>::~SkipList() {
+    auto node = head;
+    while (node) {
+        auto next = pointer(node->next(0).load());
+        destroy(node);
+        node = next;
+    }
+}
+
+template <typename Key, typename Compare>
+void SkipList<Key, Compare>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+// fills preds[level] with the last node before key and succs[level] with the
+// first node not before it, on every level, unlinking the marked nodes it
+// meets; true if succs[0] holds key. starts over when a neighbour changes
+// under it. called inside a guard
+template <typename Key, typename Compare>
+bool SkipList<Key, Compare>::search(const Key & key, Node ** preds, Node ** succs) {
+    retry:
+    auto pred = head;
+    Node * curr = nullptr;
+    for (int level = max_height - 1; level >= 0; --level) {
+        curr = pointer(pred->next(level).load());
+        while (curr) {
+            auto succ = curr->next(level).load();
+            while (marked(succ)) {
+                auto expected = link(curr);
+                if (!pred->next(level).compare_exchange_strong(expected, link(pointer(succ)))) goto retry;
+                curr = pointer(succ);
+                if (!curr) break;
+                succ = curr->next(level).load();
+            }
+            if (!curr || !less(curr->key, key)) break;
+            pred = curr;
+            curr = pointer(succ);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return curr && !less(key, curr->key);
+}
+
+template <typename Key, typename Compare>
+bool SkipList<Key, Compare>::insert(const Key & key) {
+    EpochGuard guard;
+    Node * preds[max_height];
+    Node * succs[max_height];
+    auto height = random_height();
+    Node * node = nullptr;
+    while (true) {
+        if (search(key, preds, succs)) {
+            if (node) destroy(node);
+            return false;
+        }
+        if (!node) node = create(key, height);
+        for (int level = 0; level < height; ++level) node->next(level).store(link(succs[level]));
+        auto expected = link(succs[0]);
+        // linked at level 0, the key is in the set
+        if (preds[0]->next(0).compare_exchange_strong(expected, link(node))) break;
+    }
+    ++count;
+
+    // the levels above only speed up searches, and a removal may overtake
+    // the rest of the linking; it then stops
+    for (int level = 1; level < height; ++level) {
+        while (true) {
+            auto next = node->next(level).load();
+            if (marked(next)) goto linked;
+            if (pointer(next) != succs[level] && !node->next(level).compare_exchange_strong(next, link(succs[level]))) continue;
+            auto expected = link(succs[level]);
+            if (preds[level]->next(level).compare_exchange_strong(expected, link(node))) break;
+            search(key, preds, succs);
+            if (succs[0] != node) goto linked;
+        }
+    }
+    linked:
+    // linked above a mark: the removal's own search may have passed before
+    if (marked(node->next(0).load())) search(key, preds, succs);
+    release(node);
+    return true;
+}
+
+template <typename Key, typename Compare>
+bool SkipList<Key, Compare>::remove(const Key & key) {
+    EpochGuard guard;
+    Node * preds[max_height];
+    Node * succs[max_height];
+    if (!search(key, preds, succs)) return false;
+    auto node = succs[0];
+    for (int level = node->height - 1; level > 0; --level) {
+        auto next = node->next(level).load();
+        while (!marked(next) && !node->next(level).compare_exchange_weak(next, next | 1)) {}
+    }
+    auto next = node->next(0).load();
+    while (true) {
+        // marked by another removal, which has the key
+        if (marked(next)) return false;
+        if (node->next(0).compare_exchange_weak(next, next | 1)) break;
+    }
+    --count;
+    // unlinks the tower at every level it reached
+    search(key, preds, succs);
+    release(node);
+    return true;
+}
+
+template <typename Key, typename Compare>
+bool SkipList<Key, Compare>::find(const Key & key) const {
+    EpochGuard guard;
+    auto pred = head;
+    Node * curr = nullptr;
+    for (int level = max_height - 1; level >= 0; --level) {
+        curr = pointer(pred->next(level).load());
+        while (curr && less(curr->key, key)) {
+            pred = curr;
+            curr = pointer(curr->next(level).load());
+        }
+    }
+    return curr && !less(key, curr->key) && !marked(curr->next(0).load());
+}
+
+template <typename Key, typename Compare>
+template <typename Function>
+void SkipList<Key, Compare>::scan(const Key & low, const Key & high, Function function) const {
+    EpochGuard guard;
+    auto pred = head;
+    Node * curr = nullptr;
+    for (int level = max_height - 1; level >= 0; --level) {
+        curr = pointer(pred->next(level).load());
+        while (curr && less(curr->key, low)) {
+            pred = curr;
+            curr = pointer(curr->next(level).load());
+        }
+    }
+    while (curr && !less(high, curr->key)) {
+        auto next = curr->next(0).load();
+        if (!marked(next)) function(static_cast<const Key &>(curr->key));
+        curr = pointer(next);
+    }
+}
+
+template <typename Key, typename Compare>
+template <typename Function>
+void SkipList<Key, Compare>::for_each(Function function) const {
+    EpochGuard guard;
+    for (auto curr = pointer(head->next(0).load()); curr; ) {
+        auto next = curr->next(0).load();
+        if (!marked(next)) function(static_cast<const Key &>(curr->key));
+        curr = pointer(next);
+    }
+}
+
+#endif
@@ -0,0 +1,20 @@
+#include "splay_tree.h"
+
+int main() {
+    SplayTree<int> tree;
+    tree.create();
+    tree.print(SplayTree<int>::Directions::inorder); std::cout << std::endl;
+
+    int temp;
+    std::cout << "Find: ";
+    std::cin >> temp;
+    tree.find(temp);
+    std::cout << "root: " << ((tree.root) ? tree.root->key : 0) << std::endl;
+    tree.print(SplayTree<int>::Directions::preorder); std::cout << std::endl;
+
+    std::cout << "Delete: ";
+    std::cin >> temp;
+    tree.remove(temp);
+
+    tree.print(SplayTree<int>::Directions::inorder);
+}
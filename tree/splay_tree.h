@@ -0,0 +1,281 @@
+#ifndef SPLAY_TREE_H
+#define SPLAY_TREE_H
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <functional>
+#include <utility>
+
+#include "payload.h"
+
+// same key-only layout as the balanced trees: the payload is reached through `slot`
+template <typename Key>
+struct SplayNode {
+    SplayNode * left;
+    SplayNode * right;
+    Key key;
+    std::size_t slot;
+
+    SplayNode(): left(nullptr), right(nullptr), key(), slot(0) {}
+    SplayNode(Key k, std::size_t s): left(nullptr), right(nullptr), key(k), slot(s) {}
+};
+
+// self-adjusting search tree: every access moves the touched key to the root,
+// so a small hot set stays within a few levels of the root while cold keys sink
+template <typename Key, typename Value = Empty, typename Compare = std::less<Key>>
+class SplayTree {
+    using node_type = SplayNode<Key> *;
+    using size_type = std::size_t;
+    public:
+    node_type root;
+
+    private:
+    Compare comp;
+    std::vector<Value> values;       // out-of-line payloads, indexed by SplayNode::slot
+    std::vector<size_type> free_slots;
+
+    template <typename... Args> size_type acquire(Args &&... args);
+    void release(size_type slot);
+
+    node_type splay(node_type node, const Key & key);
+    void insert(const Key & key, size_type slot);
+    void destroy(node_type node);
+
+    void preorder_traverse(node_type node) const;
+    void inorder_traverse(node_type node) const;
+    void postorder_traverse(node_type node) const;
+
+    public:
+    static enum Directions { preorder, inorder, postorder } directions;
+
+    public:
+    SplayTree(): root(nullptr) {}
+    explicit SplayTree(Compare c): root(nullptr), comp(c) {}
+    ~SplayTree() { destroy(root); }
+
+    void create();
+    bool insert(const Key & key) { return try_emplace(key); }
+    bool insert(const Key & key, Value value) { return try_emplace(key, std::move(value)); }
+    template <typename... Args> bool try_emplace(const Key & key, Args &&... args);
+    bool insert_or_assign(const Key & key, Value value);
+    void remove(const Key & key);
+    void print(enum Directions direction) const;
+
+    // lookups restructure the tree, so unlike the balanced trees they are not const
+    node_type find(const Key & key);
+
+    // pointers into the value column stay valid until the next insertion
+    Value * get(const Key & key);
+    Value & value(node_type node) { return values[node->slot]; }
+};
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::create() {
+    std::cout << "Input here: " << std::endl;
+    Key key;
+    std::string line;
+    std::getline(std::cin, line);
+    std::istringstream iss(line);
+    while (iss >> key) { insert(key); }
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename... Args>
+auto SplayTree<Key, Value, Compare>::acquire(Args &&... args) -> size_type {
+    if (free_slots.empty()) {
+        values.emplace_back(std::forward<Args>(args)...);
+        return values.size() - 1;
+    }
+    auto slot = free_slots.back();
+    free_slots.pop_back();
+    values[slot] = Value(std::forward<Args>(args)...);
+    return slot;
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::release(size_type slot) {
+    values[slot] = Value(); // drop whatever the payload owns right away
+    free_slots.push_back(slot);
+}
+
+// top-down splay: walks down once, hanging the nodes it passes on a left tree
+// (everything smaller than key) and a right tree (everything larger), then
+// reassembles them around the last node reached, which becomes the new root
+template <typename Key, typename Value, typename Compare>
+auto SplayTree<Key, Value, Compare>::splay(node_type node, const Key & key) -> node_type {
+    if (!node) return node;
+    SplayNode<Key> header;
+    auto left_max = &header;   // largest node of the left tree
+    auto right_min = &header;  // smallest node of the right tree
+    while (true) {
+        if (comp(key, node->key)) {
+            if (!node->left) break;
+            // zig-zig: rotate right first so the path to key halves
+            if (comp(key, node->left->key)) {
+                auto left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+                if (!node->left) break;
+            }
+            // link right
+            right_min->left = node;
+            right_min = node;
+            node = node->left;
+        }
+        else if (comp(node->key, key)) {
+            if (!node->right) break;
+            if (comp(node->right->key, key)) {
+                auto right = node->right;
+                node->right = right->left;
+                right->left = node;
+                node = right;
+                if (!node->right) break;
+            }
+            // link left
+            left_max->right = node;
+            left_max = node;
+            node = node->right;
+        }
+        else break;
+    }
+    // assemble
+    left_max->right = node->left;
+    right_min->left = node->right;
+    node->left = header.right;
+    node->right = header.left;
+    return node;
+}
+
+template <typename Key, typename Value, typename Compare>
+auto SplayTree<Key, Value, Compare>::find(const Key & key) -> node_type {
+    root = splay(root, key);
+    if (root && !comp(key, root->key) && !comp(root->key, key)) return root;
+    return nullptr;
+}
+
+template <typename Key, typename Value, typename Compare>
+Value * SplayTree<Key, Value, Compare>::get(const Key & key) {
+    auto node = find(key);
+    return (node) ? &values[node->slot] : nullptr;
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename... Args>
+bool SplayTree<Key, Value, Compare>::try_emplace(const Key & key, Args &&... args) {
+    // an existing key is splayed to the root but its payload is left untouched
+    if (find(key)) return false;
+    insert(key, acquire(std::forward<Args>(args)...));
+    return true;
+}
+
+template <typename Key, typename Value, typename Compare>
+bool SplayTree<Key, Value, Compare>::insert_or_assign(const Key & key, Value value) {
+    if (auto node = find(key)) {
+        values[node->slot] = std::move(value);
+        return false;
+    }
+    insert(key, acquire(std::move(value)));
+    return true;
+}
+
+// only called right after a missed find(), so the root is the key's
+// in-order neighbour and the new node simply splits the tree beneath it
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::insert(const Key & key, size_type slot) {
+    auto node = new SplayNode<Key>(key, slot);
+    if (root) {
+        if (comp(key, root->key)) {
+            node->left = root->left;
+            node->right = root;
+            root->left = nullptr;
+        }
+        else {
+            node->right = root->right;
+            node->left = root;
+            root->right = nullptr;
+        }
+    }
+    root = node;
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::remove(const Key & key) {
+    auto node = find(key);
+    if (!node) return;
+    if (!node->left) root = node->right;
+    else {
+        // every key on the left is smaller, so splaying for key brings
+        // the left subtree's maximum up with an empty right child
+        root = splay(node->left, key);
+        root->right = node->right;
+    }
+    release(node->slot);
+    delete node;
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::destroy(node_type node) {
+    // sorted insertions leave a path as deep as the tree is large, so unlink
+    // by rotating left children up instead of recursing
+    while (node) {
+        if (node->left) {
+            auto left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        }
+        else {
+            auto right = node->right;
+            delete node;
+            node = right;
+        }
+    }
+    root = nullptr;
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::preorder_traverse(node_type node) const {
+    if (node == nullptr) { return; }
+    std::cout << node->key << " ";
+    preorder_traverse(node->left);
+    preorder_traverse(node->right);
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::inorder_traverse(node_type node) const {
+    if (node == nullptr) return;
+    inorder_traverse(node->left);
+    std::cout << node->key << " ";
+    inorder_traverse(node->right);
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::postorder_traverse(node_type node) const {
+    if (node == nullptr) return;
+    postorder_traverse(node->left);
+    postorder_traverse(node->right);
+    std::cout << node->key << " ";
+}
+
+template <typename Key, typename Value, typename Compare>
+void SplayTree<Key, Value, Compare>::print(enum Directions direction) const {
+    switch (direction) {
+        case Directions::preorder: {
+            preorder_traverse(root);
+            break;
+        }
+        case Directions::inorder: {
+            inorder_traverse(root);
+            break;
+        }
+        case Directions::postorder: {
+            postorder_traverse(root);
+            break;
+        }
+    }
+}
+
+#endif
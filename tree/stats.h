@@ -0,0 +1,166 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// hot-path counters for the trees
+//
+// the trees report every event to TreeStats, which is chosen at compile time:
+// build with -DTREE_STATS to count into per-thread counters, otherwise every
+// call is an empty inline function and the instrumented code is the same as
+// without it. take TreeStats::snapshot() before and after an operation and
+// subtract to see what that operation did.
+enum class Counters {
+    comparisons,    // key comparisons
+    swaps,          // key or slot exchanges between nodes
+    rotations,      // single rotations; a double rotation counts two
+    recolorings,    // red-black color changes
+    get_parent,     // nodes visited while looking for a parent
+    allocations,    // nodes allocated
+    count
+};
+
+struct StatsSnapshot {
+    std::uint64_t values[static_cast<int>(Counters::count)];
+
+    std::uint64_t operator[](Counters counter) const { return values[static_cast<int>(counter)]; }
+    StatsSnapshot operator-(const StatsSnapshot & rhs) const {
+        StatsSnapshot result;
+        for (int i = 0; i < static_cast<int>(Counters::count); ++i) result.values[i] = values[i] - rhs.values[i];
+        return result;
+    }
+};
+
+inline const char * counter_name(Counters counter) {
+    switch (counter) {
+        case Counters::comparisons: return "comparisons";
+        case Counters::swaps: return "swaps";
+        case Counters::rotations: return "rotations";
+        case Counters::recolorings: return "recolorings";
+        case Counters::get_parent: return "get_parent";
+        case Counters::allocations: return "allocations";
+        case Counters::count: break;
+    }
+    return "";
+}
+
+inline std::ostream & operator<<(std::ostream & os, const StatsSnapshot & snapshot) {
+    for (int i = 0; i < static_cast<int>(Counters::count); ++i) {
+        os << ((i) ? " " : "") << counter_name(static_cast<Counters>(i)) << "=" << snapshot.values[i];
+    }
+    return os;
+}
+
+struct NoStats {
+    static constexpr bool enabled = false;
+    static void count(Counters, std::uint64_t = 1) {}
+    static StatsSnapshot snapshot() { return StatsSnapshot(); }
+    static void reset() {}
+};
+
+// each thread counts into its own block, so concurrent trees never share a cache line
+struct ThreadStats {
+    static constexpr bool enabled = true;
+    static std::uint64_t * values() {
+        static thread_local std::uint64_t counters[static_cast<int>(Counters::count)] = {};
+        return counters;
+    }
+    static void count(Counters counter, std::uint64_t n = 1) { values()[static_cast<int>(counter)] += n; }
+    static StatsSnapshot snapshot() {
+        StatsSnapshot snapshot;
+        std::memcpy(snapshot.values, values(), sizeof(snapshot.values));
+        return snapshot;
+    }
+    static void reset() { std::memset(values(), 0, sizeof(std::uint64_t) * static_cast<int>(Counters::count)); }
+};
+
+#ifdef TREE_STATS
+using TreeStats = ThreadStats;
+#else
+using TreeStats = NoStats;
+#endif
+
+// hardware counters of the calling thread between start() and stop(); they
+// cost a system call each way, so wrap a batch of operations rather than one
+struct HardwareSnapshot {
+    std::uint64_t cycles;
+    std::uint64_t cache_misses;
+    std::uint64_t branch_misses;
+};
+
+class PerfCounters {
+    static constexpr int events = 3;
+    int fds[events];
+
+    public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters & operator=(const PerfCounters &) = delete;
+
+    // false when the kernel refuses (no PMU in a VM, perf_event_paranoid, not Linux)
+    bool available() const { return fds[0] >= 0; }
+    void start();
+    void stop();
+    HardwareSnapshot read() const;
+};
+
+#ifdef __linux__
+inline PerfCounters::PerfCounters() {
+    const std::uint64_t configs[events] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    for (int i = 0; i < events; ++i) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+}
+
+inline PerfCounters::~PerfCounters() {
+    for (auto fd : fds) { if (fd >= 0) ::close(fd); }
+}
+
+inline void PerfCounters::start() {
+    for (auto fd : fds) {
+        if (fd < 0) continue;
+        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+inline void PerfCounters::stop() {
+    for (auto fd : fds) { if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+}
+
+inline HardwareSnapshot PerfCounters::read() const {
+    std::uint64_t values[events] = {};
+    for (int i = 0; i < events; ++i) {
+        if (fds[i] < 0 || ::read(fds[i], &values[i], sizeof(values[i])) != sizeof(values[i])) values[i] = 0;
+    }
+    return { values[0], values[1], values[2] };
+}
+#else
+inline PerfCounters::PerfCounters() { for (auto && fd : fds) fd = -1; }
+inline PerfCounters::~PerfCounters() {}
+inline void PerfCounters::start() {}
+inline void PerfCounters::stop() {}
+inline HardwareSnapshot PerfCounters::read() const { return { 0, 0, 0 }; }
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef TREE_PROTOCOL_H
+#define TREE_PROTOCOL_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// the wire format of tree_server: fixed-size records in host byte order,
+// since both ends share a host, so either side parses a whole buffer of them
+// without framing
+//
+// a request is 24 bytes. find, insert and remove look at key; range asks
+// for the keys in [key, high], at most `limit` of them (0 for the default).
+// every request gets exactly one response, in order per connection: 8 bytes,
+// then for a range `count` keys of 8 bytes each. status is 1 for found,
+// inserted or removed, and 0 otherwise
+enum class Ops : std::uint8_t { find = 1, insert = 2, remove = 3, range = 4 };
+
+struct Request {
+    std::uint32_t id;
+    Ops op;
+    std::uint8_t reserved;
+    std::uint16_t limit;
+    std::int64_t key;
+    std::int64_t high;
+};
+
+struct Response {
+    std::uint32_t id;
+    std::uint8_t status;
+    std::uint8_t reserved;
+    std::uint16_t count;
+};
+
+static_assert(sizeof(Request) == 24, "requests are 24 bytes on the wire");
+static_assert(sizeof(Response) == 8, "responses are 8 bytes on the wire");
+
+constexpr std::uint16_t default_range_limit = 256;
+constexpr const char * default_socket_path = "/tmp/tree_server.sock";
+
+inline sockaddr_un socket_address(const std::string & path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) throw std::runtime_error("socket path too long: " + path);
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+// the value at `fraction` of the way through samples, which it reorders
+template <typename T>
+T percentile(std::vector<T> & samples, double fraction) {
+    if (samples.empty()) return T();
+    auto k = std::size_t(fraction * double(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + std::ptrdiff_t(k), samples.end());
+    return samples[k];
+}
+
+#endif
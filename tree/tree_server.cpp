@@ -0,0 +1,319 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "tree_protocol.h"
+#include "avl_tree.h"
+#include "RedBlackTree/RedBlackTree/red_black_tree.h"
+
+// serves one tree over a Unix domain socket in the format of tree_protocol.h.
+// one thread owns the tree, so it needs no locking, and works in rounds:
+// one epoll_wait for every connection that is ready, one read from each,
+// every complete request of the round executed back to back, then one write
+// per connection for all of its responses. under load a round carries many
+// requests per system call; when idle it is one request, as without batching
+//
+// each connection reads into one fixed, page-aligned buffer allocated when
+// it opens, the shape io_uring wants for registered buffers, so the epoll
+// loop can give way to a submission ring without the buffers changing
+//
+// every `interval` seconds with traffic it reports the batch sizes and the
+// service time of a request, from the read that completed it to the write
+// of its response, at p50 and p99
+//
+// usage: tree_server [--avl] [-s socket] [-p preload keys] [-i report seconds]
+
+volatile std::sig_atomic_t stopping = 0;
+
+void on_signal(int) { stopping = 1; }
+
+struct Connection {
+    static constexpr std::size_t buffer_bytes = 1 << 16;
+    // past this much unsent output the connection is not read until it drains
+    static constexpr std::size_t backlog_bytes = 4 << 20;
+
+    int fd;
+    std::unique_ptr<char, decltype(&std::free)> in;
+    std::size_t in_used;
+    std::vector<char> out;
+    std::size_t out_sent;
+    std::uint32_t events;  // registered with epoll
+    bool touched;          // has output from this round
+    bool closed;
+
+    explicit Connection(int fd)
+        : fd(fd), in(static_cast<char *>(std::aligned_alloc(4096, buffer_bytes)), &std::free), in_used(0), out_sent(0), events(EPOLLIN), touched(false), closed(false) {
+        if (!in) throw std::runtime_error("cannot allocate a connection buffer");
+    }
+    ~Connection() { ::close(fd); }
+    std::size_t pending() const { return out.size() - out_sent; }
+};
+
+struct Pending {
+    Connection * connection;
+    Request request;
+};
+
+template <typename Tree>
+void execute(Tree & tree, const Request & request, std::vector<char> & out, std::vector<std::int64_t> & keys) {
+    Response response = { request.id, 0, 0, 0 };
+    keys.clear();
+    switch (request.op) {
+        case Ops::find:
+            response.status = tree.find(request.key) != nullptr;
+            break;
+        case Ops::insert:
+            response.status = tree.insert(request.key);
+            break;
+        case Ops::remove:
+            response.status = tree.find(request.key) != nullptr;
+            if (response.status) tree.remove(request.key);
+            break;
+        case Ops::range: {
+            std::size_t limit = request.limit ? request.limit : default_range_limit;
+            // the walk stops at the limit, so a wide range costs no more than a narrow one
+            tree.scan(request.key, request.high, [&](std::int64_t key, const Empty &) {
+                keys.push_back(key);
+                return keys.size() < limit;
+            });
+            response.status = 1;
+            response.count = std::uint16_t(keys.size());
+            break;
+        }
+    }
+    auto header = reinterpret_cast<const char *>(&response);
+    out.insert(out.end(), header, header + sizeof(response));
+    auto body = reinterpret_cast<const char *>(keys.data());
+    out.insert(out.end(), body, body + keys.size() * sizeof(std::int64_t));
+}
+
+class Server {
+    int listener;
+    int epoll;
+    std::vector<std::unique_ptr<Connection>> connections;
+
+    void watch(Connection & connection);
+    void accept_all();
+    void read_some(Connection & connection, std::vector<Pending> & batch);
+    void flush(Connection & connection);
+
+    public:
+    explicit Server(const std::string & path);
+    ~Server();
+
+    template <typename Tree> void run(Tree & tree, double interval);
+};
+
+Server::Server(const std::string & path) {
+    listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) throw std::runtime_error("cannot create a socket");
+    auto address = socket_address(path);
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) throw std::runtime_error("cannot bind " + path);
+    if (::listen(listener, 128) != 0) throw std::runtime_error("cannot listen on " + path);
+    epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) throw std::runtime_error("cannot create an epoll instance");
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    ::epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+}
+
+Server::~Server() {
+    connections.clear();
+    ::close(epoll);
+    ::close(listener);
+}
+
+// input while the backlog allows it, output while there is some
+void Server::watch(Connection & connection) {
+    std::uint32_t events = 0;
+    if (connection.pending() < Connection::backlog_bytes) events |= EPOLLIN;
+    if (connection.pending()) events |= EPOLLOUT;
+    if (events == connection.events) return;
+    epoll_event event = {};
+    event.events = events;
+    event.data.ptr = &connection;
+    ::epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.events = events;
+}
+
+void Server::accept_all() {
+    while (true) {
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        connections.emplace_back(new Connection(fd));
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = connections.back().get();
+        ::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+// one read, then every complete request in the buffer goes to the batch and
+// a partial one moves to the front to wait for the rest
+void Server::read_some(Connection & connection, std::vector<Pending> & batch) {
+    auto count = ::read(connection.fd, connection.in.get() + connection.in_used, Connection::buffer_bytes - connection.in_used);
+    if (count == 0 || (count < 0 && errno != EAGAIN && errno != EINTR)) {
+        connection.closed = true;
+        return;
+    }
+    if (count < 0) return;
+    connection.in_used += std::size_t(count);
+    std::size_t offset = 0;
+    for (; offset + sizeof(Request) <= connection.in_used; offset += sizeof(Request)) {
+        Pending pending;
+        pending.connection = &connection;
+        std::memcpy(&pending.request, connection.in.get() + offset, sizeof(Request));
+        batch.push_back(pending);
+    }
+    std::memmove(connection.in.get(), connection.in.get() + offset, connection.in_used - offset);
+    connection.in_used -= offset;
+}
+
+void Server::flush(Connection & connection) {
+    while (connection.pending()) {
+        auto count = ::write(connection.fd, connection.out.data() + connection.out_sent, connection.pending());
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN) connection.closed = true;
+            break;
+        }
+        connection.out_sent += std::size_t(count);
+    }
+    if (!connection.pending()) {
+        connection.out.clear();
+        connection.out_sent = 0;
+    }
+    if (!connection.closed) watch(connection);
+}
+
+template <typename Tree>
+void Server::run(Tree & tree, double interval) {
+    using clock = std::chrono::steady_clock;
+    std::vector<epoll_event> events(256);
+    std::vector<Pending> batch;
+    std::vector<Connection *> touched;
+    std::vector<std::int64_t> keys;
+    std::vector<double> service_us;
+    std::size_t rounds = 0, syscalls = 0;
+    auto last_report = clock::now();
+    auto report = [&] {
+        if (service_us.empty()) return;
+        auto requests = service_us.size();
+        std::cerr << std::fixed << std::setprecision(1) << "tree_server: " << requests << " requests in " << rounds << " rounds, "
+                  << double(requests) / double(rounds) << " per round, " << double(requests) / double(syscalls) << " per system call; "
+                  << "service p50 " << percentile(service_us, 0.5) << " us, p99 " << percentile(service_us, 0.99) << " us, "
+                  << tree.size() << " keys" << std::endl;
+        service_us.clear();
+        rounds = syscalls = 0;
+    };
+
+    while (!stopping) {
+        int ready = ::epoll_wait(epoll, events.data(), int(events.size()), 1000);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("epoll_wait failed");
+        }
+        auto start = clock::now();
+        batch.clear();
+        touched.clear();
+        for (int i = 0; i < ready; ++i) {
+            auto connection = static_cast<Connection *>(events[i].data.ptr);
+            if (!connection) {
+                accept_all();
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) flush(*connection);
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) read_some(*connection, batch);
+        }
+        syscalls += 1 + std::size_t(ready);
+
+        for (auto && pending : batch) {
+            execute(tree, pending.request, pending.connection->out, keys);
+            if (!pending.connection->touched) {
+                pending.connection->touched = true;
+                touched.push_back(pending.connection);
+            }
+        }
+        for (auto connection : touched) {
+            connection->touched = false;
+            if (!connection->closed) flush(*connection);
+            ++syscalls;
+        }
+        if (!batch.empty()) {
+            auto us = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+            service_us.insert(service_us.end(), batch.size(), us);
+            ++rounds;
+        }
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const std::unique_ptr<Connection> & c) { return c->closed; }), connections.end());
+
+        auto now = clock::now();
+        if (std::chrono::duration<double>(now - last_report).count() >= interval) {
+            report();
+            last_report = now;
+        }
+    }
+    report();
+}
+
+template <typename Tree>
+int serve(const std::string & path, std::size_t preload, double interval) {
+    Tree tree;
+    std::vector<std::int64_t> keys(preload);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(48));
+    for (auto k : keys) tree.insert(k);
+
+    Server server(path);
+    std::cerr << "tree_server: " << tree.size() << " keys, listening on " << path << std::endl;
+    server.run(tree, interval);
+    ::unlink(path.c_str());
+    return 0;
+}
+
+int main(int argc, char * argv[]) {
+    std::string path = default_socket_path;
+    std::size_t preload = 0;
+    double interval = 5;
+    bool avl = false;
+    for (int i = 1; i < argc; ++i) {
+        auto more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--avl")) avl = true;
+        else if (!std::strcmp(argv[i], "-s") && more) path = argv[++i];
+        else if (!std::strcmp(argv[i], "-p") && more) preload = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-i") && more) interval = std::atof(argv[++i]);
+        else {
+            std::cerr << "usage: tree_server [--avl] [-s socket] [-p preload keys] [-i report seconds]" << std::endl;
+            return 1;
+        }
+    }
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        if (avl) return serve<AVLTree<std::int64_t>>(path, preload, interval);
+        return serve<RedBlackTree<std::int64_t>>(path, preload, interval);
+    }
+    catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}